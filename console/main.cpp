@@ -110,6 +110,21 @@ namespace
 #endif
 	}
 
+	std::string_view flavorName(la::FlavorsRepo::Type type)
+	{
+		switch (type)
+		{
+		case la::FlavorsRepo::Type::WCSCOMLib:
+			return "comlib";
+		case la::FlavorsRepo::Type::WCSServer:
+			return "server";
+		case la::FlavorsRepo::Type::WCSAndroidLogcat:
+			return "androidLogcat";
+		default:
+			return "unknown";
+		}
+	}
+
 	bool initSystem()
 	{
 		//for Windows, set console input and output to UTF8 and enable ANSI escape codes
@@ -158,9 +173,11 @@ namespace
 
 		options.add_options()
 			("h,help", R"(Show this help)", cxxopts::value<bool>()->default_value("false"))
-			("t,type", R"(Type of logs to process)", cxxopts::value<std::string>(), R"("comlib", "server" or "androidLogcat")")
+			("t,type", R"(Type of logs to process (detected from the files content if not specified))", cxxopts::value<std::string>(), R"("comlib", "server" or "androidLogcat")")
 			("f,file", R"(Parameter "path" is a file instead of a folder)", cxxopts::value<bool>()->default_value("false"))
-			("F,fileFilter", R"-(Regex to filter which files are read from the target folder (ignored if "-f" option is used))-", cxxopts::value<std::string>());
+			("F,fileFilter", R"-(Regex to filter which files are read from the target folder (ignored if "-f" option is used))-", cxxopts::value<std::string>())
+			("c,cacheFolder", R"(Folder where the lines and search indexes are stored (next to the logs if not specified))", cxxopts::value<std::string>())
+			("n,noCache", R"(Don't load nor store the lines and search indexes)", cxxopts::value<bool>()->default_value("false"));
 
 		options.add_options("POSITIONAL")
 			("path", R"(Folder or file path (if "-f" is specified) to process)", cxxopts::value<std::vector<std::string>>());
@@ -174,9 +191,9 @@ namespace
 			return nullptr;
 		}
 
-		if (result.count("t") != 1)
+		if (result.count("t") > 1)
 		{
-			std::cerr << R"(Must have exactly one argument of "t")" << std::endl;
+			std::cerr << R"(Cannot have more than one type ("t") argument)" << std::endl;
 			return nullptr;
 		}
 
@@ -186,6 +203,12 @@ namespace
 			return nullptr;
 		}
 
+		if (result.count("c") > 1)
+		{
+			std::cerr << R"(Cannot have more than one cache folder ("c") argument)" << std::endl;
+			return nullptr;
+		}
+
 		if (result.count("path") != 1)
 		{
 			std::cerr << R"(Only one path can be specified)" << std::endl;
@@ -193,12 +216,16 @@ namespace
 		}
 
 		auto oIsFile = result["f"].as<bool>();
-		auto oFileType = convertToUTF8(result["t"].as<std::string>());
+		auto oFileType = convertToUTF8((result.count("t") == 1) ? result["t"].as<std::string>() : std::string{});
 		auto oFileFilter = convertToUTF8((result.count("F") == 1) ? result["F"].as<std::string>() : std::string{});
+		auto oCacheFolder = convertToUTF8((result.count("c") == 1) ? result["c"].as<std::string>() : std::string{});
+		auto oNoCache = result["n"].as<bool>();
 		auto oPath = convertToUTF8(result["path"].as<std::vector<std::string>>().front());
 
 		la::FlavorsRepo::Type flavorType;
-		if (oFileType == "comlib")
+		if (oFileType.empty())
+			flavorType = la::FlavorsRepo::Type::Unknown; //detected when the repo is created
+		else if (oFileType == "comlib")
 			flavorType = la::FlavorsRepo::Type::WCSCOMLib;
 		else if (oFileType == "server")
 			flavorType = la::FlavorsRepo::Type::WCSServer;
@@ -216,26 +243,25 @@ namespace
 
 		auto timestamp = std::chrono::high_resolution_clock::now();
 
+		la::LinesRepo::CacheOptions cacheOptions;
+		cacheOptions.enabled = !oNoCache;
+		cacheOptions.folderPath = oCacheFolder;
+
 		if (!oIsFile)
-		{
-			if (oFileFilter.empty())
-				repoLines = la::LinesRepo::initRepoFolder(flavorType, oPath);
-			else
-				repoLines = la::LinesRepo::initRepoFolder(flavorType, oPath, oFileFilter);
-		}
+			repoLines = la::LinesRepo::initRepoFolder(flavorType, oPath, oFileFilter, cacheOptions);
 		else
-		{
-			repoLines = la::LinesRepo::initRepoFile(flavorType, oPath);
-		}
+			repoLines = la::LinesRepo::initRepoFile(flavorType, oPath, cacheOptions);
 
-		if (repoLines->numLines() <= 0)
+		if (!repoLines || (repoLines->numLines() <= 0))
 		{
 			std::cout << (oIsFile ? "No valid lines found inside file: " : "No valid lines found inside files in folder: ") << oPath << std::endl;
 			return nullptr;
 		}
 
 		auto delta = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::high_resolution_clock::now() - timestamp).count();
-		std::cout << fmt::format("Time to parse {0} files (with a total of {1} lines): {2:.2f} ms", repoLines->numFiles(), repoLines->numLines(), delta) << std::endl;
+		std::cout << fmt::format("Time to parse {0} files (with a total of {1} lines): {2:.2f} ms (lines index cache {3})", repoLines->numFiles(), repoLines->numLines(), delta, oNoCache ? "disabled" : (repoLines->loadedFromCache() ? "hit" : "miss")) << std::endl;
+		if (oFileType.empty())
+			std::cout << "Detected type of logs: " << flavorName(repoLines->flavor()) << std::endl;
 
 		return repoLines;
 	}
@@ -507,6 +533,29 @@ int main(int argc, char* argv[])
 			continue;
 		}
 
+		if ((params.size() == 1) && ((params[0] == "r") || (params[0] == "refresh")))
+		{
+			if (!ctx.repoStack.empty())
+			{
+				std::cout << "only the initial repo can be refreshed (pop all repos first)" << std::endl;
+				continue;
+			}
+
+			auto timestamp = std::chrono::high_resolution_clock::now();
+
+			auto numNewLines = repoLines->refresh();
+			if (!numNewLines)
+			{
+				std::cout << "unable to refresh repo (files were removed or truncated)" << std::endl;
+				continue;
+			}
+
+			auto delta = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::high_resolution_clock::now() - timestamp).count();
+			std::cout << fmt::format("(refreshed repo with {} new lines in {:.2f} ms, {} files with a total of {} lines)", *numNewLines, delta, repoLines->numFiles(), repoLines->numLines()) << std::endl;
+
+			continue;
+		}
+
 		if ((params.size() == 2) && (params[0] == "exportAll"))
 		{
 			auto timestamp = std::chrono::high_resolution_clock::now();
@@ -551,6 +600,12 @@ int main(int argc, char* argv[])
 				else
 					ctx.search = repoLines->searchText(params[1], options);
 
+				if (!ctx.search.queryError().empty())
+				{
+					std::cout << "invalid query \"" << ctx.search.query() << "\": " << ctx.search.queryError() << std::endl;
+					continue;
+				}
+
 				if (!ctx.search.isValid())
 				{
 					std::cout << "can't find instances of \"" << params[1] << "\"" << std::endl;
@@ -576,6 +631,12 @@ int main(int argc, char* argv[])
 			else
 				result = repoLines->searchText(params[1], options);
 
+			if (!result.queryError().empty())
+			{
+				std::cout << "invalid query \"" << result.query() << "\": " << result.queryError() << std::endl;
+				continue;
+			}
+
 			size_t count{ 0 };
 			while (result.isValid())
 			{
@@ -598,6 +659,7 @@ int main(int argc, char* argv[])
 			std::cout << "\t i[nspect] - inspect logs" << std::endl;
 			std::cout << "\t p[rint] - print stuff" << std::endl;
 			std::cout << "\t push/pop - push or pop repo using current command result" << std::endl;
+			std::cout << "\t r[efresh] - read new content of the files (and new files)" << std::endl;
 			std::cout << "\t ex[port] - export data to a file" << std::endl;
 			std::cout << "\t exportAll - export data to a file" << std::endl;
 			std::cout << "\t f[ind] - find a specific text" << std::endl;
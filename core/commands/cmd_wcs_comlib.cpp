@@ -1,5 +1,6 @@
 #include "cmd_wcs_comlib.hpp"
 
+#include "../utils.hpp"
 #include "../lines_tools.hpp"
 #include "cmd_wcs_comlib_utils.hpp"
 
@@ -8,7 +9,6 @@
 #include <optional>
 #include <unordered_set>
 
-#include <fmt/format.h>
 #include <nlohmann/json.hpp>
 
 namespace la
@@ -18,28 +18,52 @@ namespace la
 		template<class TCallback>
 		std::vector<size_t> toolTasksExecutionsIf(const LinesTools& linesTools, TCallback&& cb)
 		{
-			std::vector<size_t> lineIndices;
+			struct TaskMatch
+			{
+				size_t lineIndex;
+				int64_t taskId;
+			};
 
 			auto& lines = linesTools.lines();
 
+			//the tasks of the matching lines, in a single pass...
+			std::vector<TaskMatch> taskMatches;
 			for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++)
 			{
-				if (!cb(lines[lineIndex]))
+				if (!cb(lines[lineIndex], lineIndex))
 					continue;
 
 				auto taskLineInfo = CommandsCOMLibUtils::taskAtLine(linesTools, lineIndex);
-				if (!taskLineInfo.has_value())
+				if (taskLineInfo.has_value())
+					taskMatches.push_back({ lineIndex, taskLineInfo.value().taskId });
+			}
+
+			//... whose lines are gathered once per task (many matching lines are usually in the same tasks)...
+			std::unordered_map<int64_t, std::vector<size_t>> tasksLineIndices;
+			for (const auto& taskMatch : taskMatches)
+			{
+				if (tasksLineIndices.find(taskMatch.taskId) == tasksLineIndices.end())
+					tasksLineIndices.emplace(taskMatch.taskId, CommandsCOMLibUtils::taskFullExecution(linesTools, taskMatch.taskId, { 0, lines.size() }));
+			}
+
+			//... and merged in order (the matching lines in a task already added are skipped)
+			std::vector<size_t> lineIndices;
+
+			size_t nextLineIndex{ 0 };
+			for (const auto& taskMatch : taskMatches)
+			{
+				if (taskMatch.lineIndex < nextLineIndex)
 					continue;
 
-				auto taskLineIndices = CommandsCOMLibUtils::taskFullExecution(linesTools, taskLineInfo.value().taskId, { 0, lines.size() });
+				const auto& taskLineIndices = tasksLineIndices[taskMatch.taskId];
 				if (taskLineIndices.empty())
 					continue;
 
-				assert(std::find(taskLineIndices.begin(), taskLineIndices.end(), lineIndex) != taskLineIndices.end());
+				assert(std::find(taskLineIndices.begin(), taskLineIndices.end(), taskMatch.lineIndex) != taskLineIndices.end());
 
 				lineIndices.insert(lineIndices.end(), taskLineIndices.begin(), taskLineIndices.end());
 
-				lineIndex = taskLineIndices.back(); //skip all the lines of this task
+				nextLineIndex = taskLineIndices.back() + 1;
 			}
 
 			return lineIndices;
@@ -82,6 +106,9 @@ namespace la
 
 			//assume that params is the task name, which means we can have multiple executions
 
+			auto paramName = linesTools.paramNames().find("name");
+			auto paramId = linesTools.paramNames().find("id");
+
 			std::vector< std::vector<size_t>> taskExecutions;
 			while (lineRange.start < lineRange.end)
 			{
@@ -90,15 +117,15 @@ namespace la
 					LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view>("task scheduled") };
 
 				std::optional<int64_t> taskId;
-				auto linesProcessed = linesTools.windowIterate({ lineRange.start, lineRange.end }, filter, [&taskId, &params](size_t, LogLine line, size_t lineIndex)
+				auto linesProcessed = linesTools.windowIterate({ lineRange.start, lineRange.end }, filter, [&linesTools, &taskId, &params, paramName, paramId](size_t, LogLine, size_t lineIndex)
 				{
 					std::string_view taskName;
-					if (!line.paramExtract("name", taskName) || (taskName != params))
+					if (!linesTools.paramExtract(lineIndex, paramName, taskName) || (taskName != params))
 						return true;
 
 					//found it...
 					int64_t id;
-					if (!line.paramExtractAs<int64_t>("id", id))
+					if (!linesTools.paramExtractAs<int64_t>(lineIndex, paramId, id))
 						return true;
 
 					taskId = id;
@@ -175,17 +202,25 @@ namespace la
 			{
 				enum class TaskStep { Unknown, Executing, Waiting, Finishing, Finished };
 
-				//find all executions
-				for (const auto& execRange : CommandsCOMLibUtils::executionsRanges(linesTools))
+				auto paramId = linesTools.paramNames().find("id");
+				auto paramName = linesTools.paramNames().find("name");
+
+				//find all executions (they don't share anything, so they are analysed in parallel and kept in order)
+				auto execRanges = CommandsCOMLibUtils::executionsRanges(linesTools);
+				executions.resize(execRanges.size());
+
+				utils::Parallel::forEach(execRanges.size(), [&linesTools, &execRanges, &executions, paramId](size_t execIndex)
 				{
-					ExecutionInfo execution;
+					const auto& execRange = execRanges[execIndex];
+
+					auto& execution = executions[execIndex];
 					execution.lineIndexStart = execRange.start;
 					execution.lineIndexEnd = execRange.end;
 
 					LinesTools::FilterCollection filter{
 						LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.Scheduler") };
 
-					[[maybe_unused]] auto linesProcessed = linesTools.windowIterate({ execRange.start, execRange.end }, filter, [&execution](size_t, LogLine line, size_t lineIndex)
+					[[maybe_unused]] auto linesProcessed = linesTools.windowIterate({ execRange.start, execRange.end }, filter, [&linesTools, &execution, paramId](size_t, LogLine line, size_t lineIndex)
 					{
 						TaskStep taskStep{ TaskStep::Unknown };
 						{
@@ -204,12 +239,13 @@ namespace la
 
 						if (taskStep == TaskStep::Executing) //gather thread ids
 						{
-							if (std::find(execution.threadIds.begin(), execution.threadIds.end(), line.threadId) == execution.threadIds.end())
-								execution.threadIds.push_back(line.threadId);
+							auto threadId = linesTools.threadIds()[lineIndex];
+							if (std::find(execution.threadIds.begin(), execution.threadIds.end(), threadId) == execution.threadIds.end())
+								execution.threadIds.push_back(threadId);
 						}
 
 						int32_t taskId;
-						if (!line.paramExtractAs<int32_t>("id", taskId))
+						if (!linesTools.paramExtractAs<int32_t>(lineIndex, paramId, taskId))
 							return true;
 
 						switch (taskStep)
@@ -243,40 +279,44 @@ namespace la
 
 					assert(linesProcessed == execRange.numLines());
 
-					//we have an execution
+					//we have an execution (its stuck tasks are resolved once all the executions are found)
 
-					{
-						//gather task names and line indices
-
-						for (auto id : execution.tasks.executing)
-							execution.tasks.info.insert({ id, {} });
-						for (auto id : execution.tasks.waiting)
-							execution.tasks.info.insert({ id, {} });
-						for (auto id : execution.tasks.finishing)
-							execution.tasks.info.insert({ id, {} });
+					for (auto id : execution.tasks.executing)
+						execution.tasks.info.insert({ id, {} });
+					for (auto id : execution.tasks.waiting)
+						execution.tasks.info.insert({ id, {} });
+					for (auto id : execution.tasks.finishing)
+						execution.tasks.info.insert({ id, {} });
+				});
 
-						auto& lines = linesTools.lines();
+				//gather task names and line indices, of the tasks of all the executions in a single parallel pass (an execution may have most of them)
+				struct StuckTask
+				{
+					size_t execIndex;
+					int64_t taskId;
+					ExecutionInfo::TaskInfo* taskInfo;
+				};
 
-						for (auto& [taskId, taskInfo] : execution.tasks.info)
-						{
-							taskInfo.lineIndices = CommandsCOMLibUtils::taskFullExecution(linesTools, taskId, { execution.lineIndexStart, execution.lineIndexEnd });
+				std::vector<StuckTask> stuckTasks;
+				for (size_t execIndex = 0; execIndex < executions.size(); execIndex++)
+				{
+					for (auto& [taskId, taskInfo] : executions[execIndex].tasks.info)
+						stuckTasks.push_back({ execIndex, taskId, &taskInfo });
+				}
 
-							{
-								auto result = linesTools.windowFindFirst({ execution.lineIndexStart, execution.lineIndexEnd }, fmt::format("| task scheduled | id={}; name=", taskId));
-								if (!result.has_value())
-									continue;
+				auto taskIndex = linesTools.taskIndex();
 
-								const auto& line = lines[*result];
-								if (!line.checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler"))
-									continue;
+				utils::Parallel::forEach(stuckTasks.size(), [&linesTools, &executions, &stuckTasks, &taskIndex, paramName](size_t index)
+				{
+					const auto& stuckTask = stuckTasks[index];
+					const auto& execution = executions[stuckTask.execIndex];
 
-								line.paramExtractAs<std::string>("name", taskInfo.name);
-							}
-						}
-					}
+					stuckTask.taskInfo->lineIndices = CommandsCOMLibUtils::taskFullExecution(linesTools, stuckTask.taskId, { execution.lineIndexStart, execution.lineIndexEnd });
 
-					executions.push_back(std::move(execution));
-				}
+					auto result = taskIndex->findFirst(stuckTask.taskId, TaskIndex::EventType::Scheduled, execution.lineIndexStart, execution.lineIndexEnd);
+					if (result.has_value())
+						linesTools.paramExtractAs<std::string>(result->lineIndex, paramName, stuckTask.taskInfo->name);
+				});
 			}
 
 			//create a json with all the necessary information
@@ -315,6 +355,10 @@ namespace la
 
 		void cmdMsgFlow(CommandsRepo::IResultCtx& resultCtx, const LinesTools& linesTools, std::string_view params, LinesTools::LineIndexRange lineRange)
 		{
+			struct {
+				uint32_t id, networkId, messageNetworkId;
+			} paramNameIds{ linesTools.paramNames().find("id"), linesTools.paramNames().find("networkId"), linesTools.paramNames().find("MessageNetworkId") };
+
 			int32_t msgId{ 0 };
 			std::string msgNetworkId;
 			{
@@ -329,24 +373,24 @@ namespace la
 					LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.ChatController"),
 					LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view>("message stored") };
 
-				linesTools.windowIterate({ lineRange.start, lineRange.end }, filter, [&msgId, &msgNetworkId, &params, &paramId](size_t, LogLine line, size_t lineIndex)
+				linesTools.windowIterate({ lineRange.start, lineRange.end }, filter, [&linesTools, &msgId, &msgNetworkId, &params, &paramId, &paramNameIds](size_t, LogLine, size_t lineIndex)
 				{
 					bool found{ false };
 					if (paramId.has_value())
-						found = line.paramCheck("id", *paramId);
+						found = linesTools.paramCheck(lineIndex, paramNameIds.id, *paramId);
 					if (!found)
-						found = line.paramCheck("networkId", params);
+						found = linesTools.paramCheck(lineIndex, paramNameIds.networkId, params);
 					if (!found)
-						found = line.paramCheck("MessageNetworkId", params);
+						found = linesTools.paramCheck(lineIndex, paramNameIds.messageNetworkId, params);
 
 					if (!found)
 						return true;
 
-					if (!line.paramExtractAs<int32_t>("id", msgId))
+					if (!linesTools.paramExtractAs<int32_t>(lineIndex, paramNameIds.id, msgId))
 						return true;
-					if (!line.paramExtractAs<std::string>("networkId", msgNetworkId))
+					if (!linesTools.paramExtractAs<std::string>(lineIndex, paramNameIds.networkId, msgNetworkId))
 						return true;
-					if (msgNetworkId.empty() && !line.paramExtractAs<std::string>("MessageNetworkId", msgNetworkId))
+					if (msgNetworkId.empty() && !linesTools.paramExtractAs<std::string>(lineIndex, paramNameIds.messageNetworkId, msgNetworkId))
 						return true;
 
 					return false;
@@ -356,17 +400,25 @@ namespace la
 			if ((msgId <= 0) || msgNetworkId.empty())
 				return;
 
-			auto lineIndices = toolTasksExecutionsIf(linesTools, [&msgId, &msgNetworkId](const LogLine& line)
+			//the params are checked first, as most lines are rejected by their params signature alone
+			//the id is compared as a number (its text may differ, e.g. "id=007;"), so only its name is in the signature
+			auto paramNetworkIdStr = "networkId=" + msgNetworkId;
+			auto paramMessageNetworkIdStr = "MessageNetworkId=" + msgNetworkId;
+
+			LinesTools::FilterParam<LinesTools::FilterType::HasParam, std::string_view> hasParamId{ "id" };
+			LinesTools::FilterParam<LinesTools::FilterType::HasParam, std::string_view> hasParamNetworkId{ paramNetworkIdStr };
+			LinesTools::FilterParam<LinesTools::FilterType::HasParam, std::string_view> hasParamMessageNetworkId{ paramMessageNetworkIdStr };
+			hasParamId.resolve(linesTools);
+			hasParamNetworkId.resolve(linesTools);
+			hasParamMessageNetworkId.resolve(linesTools);
+
+			auto lineIndices = toolTasksExecutionsIf(linesTools, [&linesTools, &msgId, &paramNameIds, &hasParamId, &hasParamNetworkId, &hasParamMessageNetworkId](const LogLine& line, size_t lineIndex)
 			{
-				if (line.checkSectionTag<LogLine::MatchType::Exact>("COMLib.ChatController") && line.checkSectionMsg<LogLine::MatchType::Exact>("message stored"))
-				{
-					if (line.paramCheck("id", msgId))
-						return true;
-					if (line.paramCheck("networkId", msgNetworkId) || line.paramCheck("MessageNetworkId", msgNetworkId))
-						return true;
-				}
+				bool hasId{ hasParamId.mayMatch(linesTools, lineIndex) && linesTools.paramCheck(lineIndex, paramNameIds.id, msgId) };
+				if (!hasId && !hasParamNetworkId(linesTools, lineIndex) && !hasParamMessageNetworkId(linesTools, lineIndex))
+					return false;
 
-				return false;
+				return (line.checkSectionTag<LogLine::MatchType::Exact>("COMLib.ChatController") && line.checkSectionMsg<LogLine::MatchType::Exact>("message stored"));
 			});
 
 			resultCtx.addLineIndices(lineIndices);
@@ -375,13 +427,13 @@ namespace la
 		void cmdSIPFlows(CommandsRepo::IResultCtx& resultCtx, const LinesTools& linesTools, std::string_view params)
 		{
 			struct {
-				std::regex extractCallID{ R"(Call-ID: (.*))", std::regex::ECMAScript | std::regex::icase };
-				std::regex extractCSeq{ R"(CSeq: .+ (.+))", std::regex::ECMAScript | std::regex::icase };
+				RegexSearcher extractCallID{ R"(Call-ID: (.*))", std::regex::ECMAScript | std::regex::icase };
+				RegexSearcher extractCSeq{ R"(CSeq: .+ (.+))", std::regex::ECMAScript | std::regex::icase };
 
-				std::regex matchTX{ R"(\.TX \d+ bytes )", std::regex::ECMAScript | std::regex::icase };
-				std::regex matchRX{ R"(\.RX \d+ bytes )", std::regex::ECMAScript | std::regex::icase };
+				RegexSearcher matchTX{ R"(\.TX \d+ bytes )", std::regex::ECMAScript | std::regex::icase };
+				RegexSearcher matchRX{ R"(\.RX \d+ bytes )", std::regex::ECMAScript | std::regex::icase };
 
-				std::regex extractNetworkData{ R"(\) (\bto\b|\bfrom\b) (?:\bTCP\b|\bUDP\b) (\d+\.\d+\.\d+\.\d+:\d+):)" };
+				RegexSearcher extractNetworkData{ R"(\) (\bto\b|\bfrom\b) (?:\bTCP\b|\bUDP\b) (\d+\.\d+\.\d+\.\d+:\d+):)" };
 			} regexs;
 
 			struct DialogData
@@ -408,7 +460,7 @@ namespace la
 					return;
 
 				LinesTools::FilterCollection filter{
-					LinesTools::FilterParam<LinesTools::FilterType::ThreadId, int32_t>(lines[lineIndex].threadId),
+					LinesTools::FilterParam<LinesTools::FilterType::ThreadId, int32_t>(linesTools.threadIds()[lineIndex]),
 					LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.PJSIP"),
 					LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view, LogLine::MatchType::Contains>("pjsua_core.c") };
 
@@ -417,7 +469,7 @@ namespace la
 					auto content = line.getSectionMsg();
 
 					std::cmatch matches;
-					if (!std::regex_search(content.data(), content.data() + content.size(), matches, regexs.extractCallID))
+					if (!regexs.extractCallID.search(content.data(), content.data() + content.size(), matches))
 						return true;
 
 					filterDiagCallId = std::string_view{ matches[1].first, static_cast<size_t>(matches[1].second - matches[1].first) };
@@ -442,7 +494,7 @@ namespace la
 			{
 				dialogs.clear();
 
-				linesTools.windowIterate({ execRange.start, execRange.end }, filter, [&regexs, &dialogs, &filterDiagCallId, &resultCtx](size_t, LogLine line, size_t lineIndex)
+				linesTools.windowIterate({ execRange.start, execRange.end }, filter, [&linesTools, &regexs, &dialogs, &filterDiagCallId, &resultCtx](size_t, LogLine line, size_t lineIndex)
 				{
 					auto content = line.getSectionMsg();
 
@@ -454,7 +506,7 @@ namespace la
 							return true;
 
 						offset += 2;
-						body = std::string_view{ line.data.start + line.sectionMsg.offset + offset, line.sectionMsg.size - offset };
+						body = content.substr(offset);
 
 						std::string_view ignoreSufix{ "\n--end msg--" };
 						if ((body.size() >= ignoreSufix.size()) && (body.compare(body.length() - ignoreSufix.length(), ignoreSufix.length(), ignoreSufix) == 0))
@@ -465,7 +517,7 @@ namespace la
 					std::string_view callId;
 					{
 						std::cmatch matches;
-						if (!std::regex_search(content.data(), content.data() + content.size(), matches, regexs.extractCallID))
+						if (!regexs.extractCallID.search(content.data(), content.data() + content.size(), matches))
 							return true;
 
 						callId = std::string_view{ matches[1].first, static_cast<size_t>(matches[1].second - matches[1].first) };
@@ -482,13 +534,13 @@ namespace la
 						if (dialog.method.empty())
 						{
 							std::cmatch matches;
-							if (std::regex_search(content.data(), content.data() + content.size(), matches, regexs.extractCSeq))
+							if (regexs.extractCSeq.search(content.data(), content.data() + content.size(), matches))
 								dialog.method = { matches[1].first, static_cast<size_t>(matches[1].second - matches[1].first) };
 						}
 
-						if (std::regex_search(content.data(), content.data() + content.size(), regexs.matchTX))
+						if (regexs.matchTX.search(content.data(), content.data() + content.size()))
 							dialog.txLineIndices.push_back(lineIndex);
-						else if (std::regex_search(content.data(), content.data() + content.size(), regexs.matchRX))
+						else if (regexs.matchRX.search(content.data(), content.data() + content.size()))
 							dialog.rxLineIndices.push_back(lineIndex);
 
 						dialog.lineIndices.push_back(lineIndex);
@@ -499,7 +551,7 @@ namespace la
 						std::string srcAddress, dstAddress;
 
 						std::cmatch matchesRoot;
-						if (std::regex_search(content.data(), content.data() + content.size(), matchesRoot, regexs.extractNetworkData))
+						if (regexs.extractNetworkData.search(content.data(), content.data() + content.size(), matchesRoot))
 						{
 							std::string_view dir{ matchesRoot[1].first, static_cast<size_t>(matchesRoot[1].second - matchesRoot[1].first) };
 							assert((dir == "to") || (dir == "from"));
@@ -508,13 +560,13 @@ namespace la
 
 							CommandsRepo::IResultCtx::LineContent lineContent;
 							lineContent.lineIndex = lineIndex;
-							lineContent.contentOffset = body.data() - line.data.start;
+							lineContent.contentOffset = body.data() - line.dataStart;
 							lineContent.contentSize = body.size();
 
 							if (dir == "to")
-								resultCtx.addNetworkPacketIPV4("127.0.0.1:0", rootAddress, line.timestamp, lineContent);
+								resultCtx.addNetworkPacketIPV4("127.0.0.1:0", rootAddress, linesTools.timestamps()[lineIndex], lineContent);
 							else
-								resultCtx.addNetworkPacketIPV4(rootAddress, "127.0.0.1:0", line.timestamp, lineContent);
+								resultCtx.addNetworkPacketIPV4(rootAddress, "127.0.0.1:0", linesTools.timestamps()[lineIndex], lineContent);
 						}
 					}
 
@@ -562,21 +614,21 @@ namespace la
 					LinesTools::FilterParam<LinesTools::FilterType::Method, std::string_view, LogLine::MatchType::Exact>("operator()") };
 
 			std::set<int32_t> threadIds;
-			linesTools.iterateForward(0, filter, [&threadIds](size_t, LogLine line, size_t)
+			linesTools.iterateForward(0, filter, [&linesTools, &threadIds](size_t, LogLine, size_t lineIndex)
 			{
-				threadIds.insert(line.threadId);
+				threadIds.insert(linesTools.threadIds()[lineIndex]);
 				return true;
 			});
 
 			if (threadIds.empty())
 				return;
 
-			auto& lines = linesTools.lines();
+			auto& linesThreadIds = linesTools.threadIds();
 
 			std::vector<size_t> lineIndices;
-			for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++)
+			for (size_t lineIndex = 0; lineIndex < linesThreadIds.size(); lineIndex++)
 			{
-				if (threadIds.count(lines[lineIndex].threadId) <= 0)
+				if (threadIds.count(linesThreadIds[lineIndex]) <= 0)
 					continue;
 
 				lineIndices.push_back(lineIndex);
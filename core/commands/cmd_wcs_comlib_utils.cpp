@@ -1,9 +1,7 @@
 #include "cmd_wcs_comlib_utils.hpp"
 
-#include <array>
 #include <cassert>
-
-#include <fmt/format.h>
+#include <algorithm>
 
 namespace la
 {
@@ -39,86 +37,49 @@ namespace la
 	{
 		std::vector<size_t> lineIndices;
 
-		auto& lines = linesTools.lines();
+		auto taskIndex = linesTools.taskIndex();
 
 		//find where the task is scheduled
 		size_t taskStartLineIndex;
 		{
-			auto result = linesTools.windowFindFirst({ lineRange.start, lineRange.end }, fmt::format("| task scheduled | id={}; name=", taskId));
-			if (!result.has_value() || !lines[*result].checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler"))
+			auto result = taskIndex->findFirst(taskId, TaskIndex::EventType::Scheduled, lineRange.start, lineRange.end);
+			if (!result.has_value())
 				return {};
 
-			lineIndices.push_back(*result);
-			taskStartLineIndex = *result; //as an optimization, we don't need to start at the beginning of the logs
+			lineIndices.push_back(result->lineIndex);
+			taskStartLineIndex = result->lineIndex;
 		}
 
 		//find where the task is finished (which migth not exist if the app was killed)
 		size_t taskEndLineIndex{ lineRange.end };
 		{
-			auto result = linesTools.windowFindFirst({ taskStartLineIndex, lineRange.end }, fmt::format("| task finished | id={}; name=", taskId));
-			if (result.has_value() && lines[*result].checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler"))
+			auto result = taskIndex->findFirst(taskId, TaskIndex::EventType::Finished, taskStartLineIndex, lineRange.end);
+			if (result.has_value())
 			{
-				lineIndices.push_back(*result);
-				taskEndLineIndex = *result; //as an optimization, we don't need to finish at the end of the logs
+				lineIndices.push_back(result->lineIndex);
+				taskEndLineIndex = result->lineIndex;
 			}
 		}
 
-		//gather all non execution or finishing events
-		{
-			static std::array<std::string_view, 10> Queries{ {
-				"| task waiting (sync) | id={}; waiting for=",
-				"| task waiting (time) | id={}; ms=",
-				"| task waiting (task) | id={}; waiting for=",
-				"| task moving on (sync) | id={}; waited for=",
-				"| task moving on (task) | id={}; waited for=",
-				"| task cancelled | id={};",
-				"| scheduler canceled a task that didn't have support to be canceled | id={}; name=",
-				"| canceling task because task is already running | id={}; name=",
-				"| ignoring task remove because task is already running | id={}; name=",
-				"| removed task | id={}; name="
-			} };
-
-			for (const auto& query : Queries)
-			{
-				for (auto curLineIndex : linesTools.windowFindAll({ taskStartLineIndex, taskEndLineIndex }, fmt::format(query, taskId)))
-				{
-					if (lines[curLineIndex].checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler"))
-						lineIndices.push_back(curLineIndex);
-				}
-			}
-		}
+		//all the other events in between (the executions and finishings also have the steps which follow them in their thread)
+		std::vector<size_t> stepsLineIndices;
 
-		//gather all executions and execution steps
-		for (auto curLineIndex : linesTools.windowFindAll({ taskStartLineIndex, taskEndLineIndex }, fmt::format("| task executing | id={}; name=", taskId)))
+		const auto& events = taskIndex->taskEvents(taskId);
+		auto itEvent = std::lower_bound(events.begin(), events.end(), taskStartLineIndex, [](const TaskIndex::Event& event, size_t lineIndex) { return (event.lineIndex < lineIndex); });
+		for (; (itEvent != events.end()) && (itEvent->lineIndex < taskEndLineIndex); itEvent++)
 		{
-			if (!lines[curLineIndex].checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler"))
+			if ((itEvent->type == TaskIndex::EventType::Scheduled) || (itEvent->type == TaskIndex::EventType::Finished))
 				continue;
 
-			lineIndices.push_back(curLineIndex);
-
-			LinesTools::FilterCollection filter{
-				LinesTools::FilterParam<LinesTools::FilterType::ThreadId, int32_t>(lines[curLineIndex].threadId) };
-
-			linesTools.windowIterate({ curLineIndex + 1, taskEndLineIndex }, filter, [&lineIndices](size_t, LogLine line, size_t lineIndex)
-			{
-				if (line.checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler") && !line.checkSectionMsg<LogLine::MatchType::Exact>("task scheduled"))
-					return false;
-
-				lineIndices.push_back(lineIndex);
-				return true;
-			});
+			lineIndices.push_back(itEvent->lineIndex);
+			if ((itEvent->type == TaskIndex::EventType::Executing) || (itEvent->type == TaskIndex::EventType::Finishing))
+				stepsLineIndices.push_back(itEvent->lineIndex);
 		}
 
-		//gather the finishing steps
-		for (auto curLineIndex : linesTools.windowFindAll({ taskStartLineIndex, taskEndLineIndex }, fmt::format("| task finishing | id={}; name=", taskId)))
+		for (auto curLineIndex : stepsLineIndices)
 		{
-			if (!lines[curLineIndex].checkSectionTag<LogLine::MatchType::Exact>("COMLib.Scheduler"))
-				continue;
-
-			lineIndices.push_back(curLineIndex);
-
 			LinesTools::FilterCollection filter{
-				LinesTools::FilterParam<LinesTools::FilterType::ThreadId, int32_t>(lines[curLineIndex].threadId) };
+				LinesTools::FilterParam<LinesTools::FilterType::ThreadId, int32_t>(linesTools.threadIds()[curLineIndex]) };
 
 			linesTools.windowIterate({ curLineIndex + 1, taskEndLineIndex }, filter, [&lineIndices](size_t, LogLine line, size_t lineIndex)
 			{
@@ -142,41 +103,18 @@ namespace la
 		if (lineIndex >= lines.size())
 			return std::nullopt;
 
-		std::optional<TaskLineInfo> taskLineInfo;
-		{
-			LinesTools::FilterCollection filter{
-					LinesTools::FilterParam<LinesTools::FilterType::ThreadId, int32_t>(lines[lineIndex].threadId),
-					LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.Scheduler"),
-					LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view>("task executing") };
-
-			linesTools.iterateBackwards(lineIndex, filter, [&taskLineInfo](size_t, LogLine line, size_t lineIndex)
-			{
-				int64_t id;
-				if (!line.paramExtractAs<int64_t>("id", id))
-					return true;
-
-				taskLineInfo = { id, lineIndex };
-				return false;
-			});
-		}
+		auto taskIndex = linesTools.taskIndex();
 
-		if (!taskLineInfo.has_value())
+		//the task the thread of the line is executing
+		auto execution = taskIndex->lastExecution(linesTools.threadIds()[lineIndex], lineIndex + 1);
+		if (!execution.has_value())
 			return std::nullopt;
 
-		//find the task first line index
-
-		auto paramCheck = fmt::format("id={}; name=", taskLineInfo.value().taskId);
-
-		LinesTools::FilterCollection filter{
-				LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.Scheduler"),
-				LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view>("task scheduled"),
-				LinesTools::FilterParam<LinesTools::FilterType::Params, std::string_view, LogLine::MatchType::StartsWith>(paramCheck) };
+		TaskLineInfo taskLineInfo{ execution->taskId, execution->lineIndex };
 
-		linesTools.iterateBackwards(taskLineInfo.value().firstLineIndex, filter, [&taskLineInfo](size_t, LogLine, size_t lineIndex)
-		{
-			taskLineInfo.value().firstLineIndex = lineIndex;
-			return false;
-		});
+		//find the task first line index
+		if (auto result = taskIndex->findLast(execution->taskId, TaskIndex::EventType::Scheduled, execution->lineIndex); result.has_value())
+			taskLineInfo.firstLineIndex = result->lineIndex;
 
 		return taskLineInfo;
 	}
@@ -185,41 +123,37 @@ namespace la
 	{
 		std::vector<size_t> lineIndices;
 
+		auto requestIndex = linesTools.httpRequestIndex();
+
 		//find where the HTTP request is scheduled
 		size_t taskStartLineIndex;
 		{
-			auto result = linesTools.windowFindFirst({ lineRange.start, lineRange.end }, fmt::format("|COMLib.HTTP: asioProcessDispatcher | request new | id={}; method=", httpRequestId));
+			auto result = requestIndex->findFirst(httpRequestId, HTTPRequestIndex::EventType::New, lineRange.start, lineRange.end);
 			if (!result.has_value())
 				return {};
 
-			lineIndices.push_back(*result);
-			taskStartLineIndex = *result; //as an optimization, we don't need to start at the beginning of the logs
+			lineIndices.push_back(result->lineIndex);
+			taskStartLineIndex = result->lineIndex;
 		}
 
 		//find where the HTTP request is finished (which migth not exist if the app was killed)
 		size_t taskEndLineIndex{ lineRange.end };
 		{
-			auto result = linesTools.windowFindFirst({ taskStartLineIndex, lineRange.end }, fmt::format("|COMLib.HTTP: asioProcessTerminated | request finished | requestId={}; result=", httpRequestId));
+			auto result = requestIndex->findFirst(httpRequestId, HTTPRequestIndex::EventType::Finished, taskStartLineIndex, lineRange.end);
 			if (result.has_value())
 			{
-				lineIndices.push_back(*result);
-				taskEndLineIndex = *result; //as an optimization, we don't need to finish at the end of the logs
+				lineIndices.push_back(result->lineIndex);
+				taskEndLineIndex = result->lineIndex;
 			}
 		}
 
 		//gather all execution steps
+		const auto& events = requestIndex->requestEvents(httpRequestId);
+		auto itEvent = std::lower_bound(events.begin(), events.end(), taskStartLineIndex, [](const HTTPRequestIndex::Event& event, size_t lineIndex) { return (event.lineIndex < lineIndex); });
+		for (; (itEvent != events.end()) && (itEvent->lineIndex < taskEndLineIndex); itEvent++)
 		{
-			LinesTools::FilterCollection filter{
-					LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.HTTP"),
-					LinesTools::FilterParam<LinesTools::FilterType::Method, std::string_view>("curlDebugCallback") };
-
-			linesTools.windowIterate({ taskStartLineIndex, taskEndLineIndex }, filter, [&lineIndices, httpRequestId](size_t, LogLine line, size_t lineIndex)
-			{
-				if (line.paramCheck<int64_t>("request", httpRequestId))
-					lineIndices.push_back(lineIndex);
-
-				return true;
-			});
+			if (itEvent->type == HTTPRequestIndex::EventType::Debug)
+				lineIndices.push_back(itEvent->lineIndex);
 		}
 
 		std::sort(lineIndices.begin(), lineIndices.end());
@@ -243,36 +177,24 @@ namespace la
 		if (targetLine.checkSectionMethod<LogLine::MatchType::Exact>("curlDebugCallback"))
 		{
 			int64_t httpRequestId;
-			if (targetLine.paramExtractAs<int64_t>("request", httpRequestId))
+			if (linesTools.paramExtractAs<int64_t>(lineIndex, linesTools.paramNames().find("request"), httpRequestId))
 				httpLineInfo = { httpRequestId, lineIndex };
 		}
 		else if (targetLine.checkSectionMethod<LogLine::MatchType::Exact>("asioProcessDispatcher") || targetLine.checkSectionMethod<LogLine::MatchType::Exact>("asioProcessTerminated"))
 		{
 			int64_t httpRequestId;
-			if (targetLine.paramExtractAs<int64_t>("requestId", httpRequestId))
+			if (linesTools.paramExtractAs<int64_t>(lineIndex, linesTools.paramNames().find("requestId"), httpRequestId))
 				httpLineInfo = { httpRequestId, lineIndex };
-			else if (targetLine.paramExtractAs<int64_t>("id", httpRequestId))
+			else if (linesTools.paramExtractAs<int64_t>(lineIndex, linesTools.paramNames().find("id"), httpRequestId))
 				httpLineInfo = { httpRequestId, lineIndex };
 		}
 
 		if (!httpLineInfo.has_value())
 			return std::nullopt;
 
-		//find the task first line index
-
-		auto paramCheck = fmt::format("id={}; method=", httpLineInfo.value().httpRequestId);
-
-		LinesTools::FilterCollection filter{
-				LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.HTTP"),
-				LinesTools::FilterParam<LinesTools::FilterType::Method, std::string_view>("asioProcessDispatcher"),
-				LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view>("request new"),
-				LinesTools::FilterParam<LinesTools::FilterType::Params, std::string_view, LogLine::MatchType::StartsWith>(paramCheck) };
-
-		linesTools.iterateBackwards(httpLineInfo.value().firstLineIndex, filter, [&httpLineInfo](size_t, LogLine, size_t lineIndex)
-		{
-			httpLineInfo.value().firstLineIndex = lineIndex;
-			return false;
-		});
+		//find the request first line index
+		if (auto result = linesTools.httpRequestIndex()->findLast(httpLineInfo.value().httpRequestId, HTTPRequestIndex::EventType::New, httpLineInfo.value().firstLineIndex + 1); result.has_value())
+			httpLineInfo.value().firstLineIndex = result->lineIndex;
 
 		return httpLineInfo;
 	}
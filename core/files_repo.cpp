@@ -1,10 +1,35 @@
 #include "files_repo.hpp"
 
 #include <regex>
+#include <cstring>
+#include <optional>
+#include <algorithm>
 #include <filesystem>
 
 namespace la
 {
+	namespace
+	{
+		//how much of the start and of the end of the previous content must match for a file to be considered the same
+		constexpr size_t FileMatchSize{ 4096 };
+
+		bool isSameFile(const MemoryMappedFile& previous, const MemoryMappedFile& current) noexcept
+		{
+			if (current.size() < previous.size())
+				return false;
+
+			auto matchSize = std::min(previous.size(), FileMatchSize);
+			auto previousData = previous.dataAs<const char*>();
+			auto currentData = current.dataAs<const char*>();
+
+			if (std::memcmp(previousData, currentData, matchSize) != 0)
+				return false;
+
+			auto matchOffset = previous.size() - matchSize;
+			return (std::memcmp(previousData + matchOffset, currentData + matchOffset, matchSize) == 0);
+		}
+	}
+
 	std::vector<std::string> FilesRepo::listFolderFiles(FlavorsRepo::Type type, std::string_view folderPath)
 	{
 		return FlavorsRepo::listFolderFiles(type, folderPath);
@@ -16,8 +41,14 @@ namespace la
 		if (!(*fileMapping))
 			return nullptr;
 
-		auto repo = std::unique_ptr<FilesRepo>{ new FilesRepo(type) };
+		if (type == FlavorsRepo::Type::Unknown)
+			type = FlavorsRepo::retrieveDataType(fileMapping->data(), fileMapping->size());
+		if (type == FlavorsRepo::Type::Unknown)
+			return nullptr;
+
+		auto repo = std::unique_ptr<FilesRepo>{ new FilesRepo(type, false, std::string{ filePath }, false, {}) };
 		repo->m_files.push_back(std::move(fileMapping));
+		repo->m_filesPaths.emplace_back(filePath);
 
 		return repo;
 	}
@@ -29,47 +60,135 @@ namespace la
 
 	std::unique_ptr<FilesRepo> FilesRepo::initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath, std::string_view fileNameFilterRegex)
 	{
-		if (fileNameFilterRegex.empty())
+		if (!fileNameFilterRegex.empty())
 		{
-			auto repo = std::unique_ptr<FilesRepo>{ new FilesRepo(type) };
-
-			FlavorsRepo::iterateFolderFiles(type, folderPath, [&repo](std::string filePath)
+			try
 			{
-				auto fileMapping = std::make_unique<la::MemoryMappedFile>(filePath);
-				if (!(*fileMapping))
-					return;
+				std::regex{ std::string{ fileNameFilterRegex } };
+			}
+			catch (std::regex_error const&)
+			{
+				return nullptr;
+			}
+		}
 
-				repo->m_files.push_back(std::move(fileMapping));
-			});
+		auto flavorDetected = (type == FlavorsRepo::Type::Unknown);
+		if (flavorDetected)
+			type = FlavorsRepo::retrieveFolderType(folderPath);
+		if (type == FlavorsRepo::Type::Unknown)
+			return nullptr;
 
-			return repo;
-		}
+		auto repo = std::unique_ptr<FilesRepo>{ new FilesRepo(type, flavorDetected, std::string{ folderPath }, true, std::string{ fileNameFilterRegex }) };
 
-		std::regex regFilter;
+		repo->listFilesPaths([&repo](std::string filePath)
+		{
+			auto fileMapping = std::make_unique<la::MemoryMappedFile>(filePath);
+			if (!(*fileMapping))
+				return;
 
-		try
+			repo->m_files.push_back(std::move(fileMapping));
+			repo->m_filesPaths.push_back(std::move(filePath));
+		});
+
+		return repo;
+	}
+
+	bool FilesRepo::refresh(std::vector<FileChange>& changes)
+	{
+		changes.clear();
+
+		std::vector<std::string> filesPaths;
+		listFilesPaths([&filesPaths](std::string filePath)
 		{
-			regFilter = std::regex{ std::string{ fileNameFilterRegex } };
+			filesPaths.push_back(std::move(filePath));
+		});
+
+		//find where the last file is now (a rotation may have renamed it), starting from the newest one
+		size_t newFilesIndex{ 0 };
+		if (!m_files.empty())
+		{
+			std::unique_ptr<MemoryMappedFile> lastFile;
+			for (auto i = filesPaths.size(); i > 0; i--)
+			{
+				auto fileMapping = std::make_unique<la::MemoryMappedFile>(filesPaths[i - 1]);
+				if (!(*fileMapping) || !isSameFile(*m_files.back(), *fileMapping))
+					continue;
+
+				lastFile = std::move(fileMapping);
+				m_filesPaths.back() = filesPaths[i - 1];
+				newFilesIndex = i;
+				break;
+			}
+
+			//gone or truncated, the repo must be created again
+			if (!lastFile)
+				return false;
+
+			if (lastFile->size() > m_files.back()->size())
+			{
+				changes.push_back({ m_files.back()->data(), m_files.back()->size(), lastFile->data(), lastFile->size() });
+
+				m_replacedFiles.push_back(std::move(m_files.back()));
+				m_files.back() = std::move(lastFile);
+			}
 		}
-		catch (std::regex_error const&)
+
+		for (auto i = newFilesIndex; i < filesPaths.size(); i++)
 		{
-			return nullptr;
+			auto fileMapping = std::make_unique<la::MemoryMappedFile>(filesPaths[i]);
+			if (!(*fileMapping))
+				continue;
+
+			changes.push_back({ nullptr, 0, fileMapping->data(), fileMapping->size() });
+			m_files.push_back(std::move(fileMapping));
+			m_filesPaths.push_back(std::move(filesPaths[i]));
 		}
 
-		auto repo = std::unique_ptr<FilesRepo>{ new FilesRepo(type) };
+		return true;
+	}
 
-		FlavorsRepo::iterateFolderFiles(type, folderPath, [&repo, &regFilter](std::string filePath)
+	void FilesRepo::listFilesPaths(const std::function<void(std::string filePath)>& cb)
+	{
+		if (!m_pathIsFolder)
 		{
-			if (!std::regex_search(filePath, regFilter))
+			cb(m_path);
+			return;
+		}
+
+		std::optional<std::regex> regFilter;
+		if (!m_fileNameFilterRegex.empty())
+		{
+			try
+			{
+				regFilter = std::regex{ m_fileNameFilterRegex };
+			}
+			catch (std::regex_error const&)
+			{
 				return;
+			}
+		}
 
-			auto fileMapping = std::make_unique<la::MemoryMappedFile>(filePath);
-			if (!(*fileMapping))
+		FlavorsRepo::iterateFolderFiles(m_flavor, m_path, [this, &cb, &regFilter](std::string filePath)
+		{
+			if (regFilter.has_value() && !std::regex_search(filePath, regFilter.value()))
 				return;
 
-			repo->m_files.push_back(std::move(fileMapping));
-		});
+			//a detected flavor only takes the files of its group, as grouped when detecting it (each file is checked once it has content)
+			if (m_flavorDetected)
+			{
+				auto itType = m_filesTypes.find(filePath);
+				if (itType == m_filesTypes.end())
+				{
+					auto fileType = FlavorsRepo::retrieveFileType(filePath);
+					if (fileType != FlavorsRepo::Type::Unknown)
+						itType = m_filesTypes.emplace(filePath, fileType).first;
+				}
+
+				if (!FlavorsRepo::isGroupFile(m_flavor, (itType != m_filesTypes.end()) ? itType->second : FlavorsRepo::Type::Unknown))
+					return;
+			}
 
-		return repo;
+			cb(std::move(filePath));
+		});
 	}
 }
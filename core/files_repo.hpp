@@ -7,11 +7,23 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <functional>
+#include <unordered_map>
 
 namespace la
 {
 	class FilesRepo final
 	{
+	public:
+		struct FileChange
+		{
+			const void* previousData{ nullptr }; //nullptr for new files (otherwise it's still mapped)
+			size_t previousSize{ 0 };
+
+			const void* data{ nullptr };
+			size_t size{ 0 };
+		};
+
 	public:
 		static std::vector<std::string> listFolderFiles(FlavorsRepo::Type type, std::string_view folderPath);
 
@@ -37,6 +49,21 @@ namespace la
 			return m_files.size();
 		}
 
+		std::string_view path() const noexcept
+		{
+			return m_path;
+		}
+
+		bool pathIsFolder() const noexcept
+		{
+			return m_pathIsFolder;
+		}
+
+		std::string_view fileNameFilterRegex() const noexcept
+		{
+			return m_fileNameFilterRegex;
+		}
+
 		template<class TCallback>
 		void iterateFiles(TCallback&& cb) const noexcept
 		{
@@ -44,14 +71,38 @@ namespace la
 				cb(file->data(), file->size());
 		}
 
+		template<class TCallback>
+		void iterateFilesPaths(TCallback&& cb) const noexcept
+		{
+			for (size_t i = 0; i < m_files.size(); i++)
+				cb(std::string_view{ m_filesPaths[i] }, m_files[i]->data(), m_files[i]->size());
+		}
+
+		//only the last file can grow and new files can only be placed after it (a renamed file is found by its content)
+		bool refresh(std::vector<FileChange>& changes);
+
 	private:
-		FilesRepo(FlavorsRepo::Type flavor) noexcept
+		FilesRepo(FlavorsRepo::Type flavor, bool flavorDetected, std::string path, bool pathIsFolder, std::string fileNameFilterRegex) noexcept
 			: m_flavor{ flavor }
+			, m_flavorDetected{ flavorDetected }
+			, m_path{ std::move(path) }
+			, m_pathIsFolder{ pathIsFolder }
+			, m_fileNameFilterRegex{ std::move(fileNameFilterRegex) }
 		{ }
 
+		void listFilesPaths(const std::function<void(std::string filePath)>& cb);
+
 	private:
 		FlavorsRepo::Type m_flavor{ FlavorsRepo::Type::Unknown };
+		bool m_flavorDetected{ false }; //only the files of the detected group are loaded from the folder (otherwise, all the ones named like the flavor)
+		std::unordered_map<std::string, FlavorsRepo::Type> m_filesTypes; //the detected flavor of each file named like the repo one (only when known, an empty file may still get its first lines)
 		std::vector<std::unique_ptr<MemoryMappedFile>> m_files;
+		std::vector<std::string> m_filesPaths;
+		std::vector<std::unique_ptr<MemoryMappedFile>> m_replacedFiles; //previous mappings of files that grew (log lines may still point to them)
+
+		std::string m_path;
+		bool m_pathIsFolder{ false };
+		std::string m_fileNameFilterRegex;
 	};
 }
 
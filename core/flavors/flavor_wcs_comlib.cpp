@@ -9,10 +9,10 @@ namespace la::flavors
 {
 	namespace
 	{
-		bool parse(LogLine& line)
+		bool parse(LogLine& line, LogLineHeader& header)
 		{
-			auto walker = line.data.start;
-			auto walkerEnd = line.data.end;
+			auto walker = line.dataStart;
+			auto walkerEnd = line.dataEnd();
 
 			//parse and convert the initial data (timestamp, level, etc.)
 			{
@@ -23,8 +23,8 @@ namespace la::flavors
 
 				//parse timestamp
 				{
-					line.timestamp = FlavorsRepo::translateTimestamp(walker);
-					if (line.timestamp == 0)
+					header.timestamp = FlavorsRepo::translateTimestamp(walker);
+					if (header.timestamp == 0)
 						return false;
 
 					walker += 23;
@@ -47,7 +47,7 @@ namespace la::flavors
 					if (auto [p, ec] = std::from_chars(walker, next, threadId); ec != std::errc())
 						return false;
 
-					line.threadId = threadId;
+					header.threadId = threadId;
 
 					walker = next + 1; //ignore last space
 				}
@@ -58,11 +58,10 @@ namespace la::flavors
 						return false;
 
 					walker++;
-					if (!FlavorsRepo::translateLogLevel(*walker, line.level))
+					if (!FlavorsRepo::translateLogLevel(*walker, header.level))
 						return false;
 
-					while ((walker < walkerEnd) && (walker[0] != '|'))
-						walker++;
+					walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
 					if (walker >= walkerEnd)
 						return false;
@@ -72,8 +71,7 @@ namespace la::flavors
 
 				//skip account
 				{
-					while ((walker < walkerEnd) && (walker[0] != '|'))
-						walker++;
+					walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
 					if (walker >= walkerEnd)
 						return false;
@@ -86,13 +84,11 @@ namespace la::flavors
 
 			//read the tag
 			{
-				line.sectionTag.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionTag.size = 0;
+				auto sectionStart = walker;
+				walker = FlavorsRepo::findSeparator(walker, walkerEnd, ':');
 
-				while ((walker < walkerEnd) && (walker[0] != ':'))
-					walker++;
-
-				line.sectionTag.size = static_cast<uint32_t>(walker - line.data.start - line.sectionTag.offset);
+				if (!line.setSection(LogLine::SectionType::Tag, sectionStart - line.dataStart, walker - sectionStart))
+					return false;
 
 				walker++; //ignore ':'
 			}
@@ -103,18 +99,15 @@ namespace la::flavors
 					return false;
 
 				walker++; //skip space
-				line.sectionMethod.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionMethod.size = 0;
+				auto sectionStart = walker;
+				walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
-				while ((walker < walkerEnd) && (*walker != '|'))
-					walker++;
-
-				line.sectionMethod.size = static_cast<uint32_t>(walker - line.data.start - line.sectionMethod.offset);
+				if ((walker <= sectionStart) || (walker[-1] != ' ')) //last caracter before '|' must be a space
+					return false;
 
-				if ((line.sectionMethod.size < 1) || (walker[-1] != ' ')) //last caracter before '|' must be a space
+				if (!line.setSection(LogLine::SectionType::Method, sectionStart - line.dataStart, walker - sectionStart - 1)) //ignore last space
 					return false;
 
-				line.sectionMethod.size--; //ignore last space
 				walker++; //ignore '|'
 			}
 
@@ -124,22 +117,21 @@ namespace la::flavors
 					return false;
 
 				walker++; //skip space
-				line.sectionMsg.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionMsg.size = 0;
-
-				while ((walker < walkerEnd) && (walker[0] != '|'))
-					walker++;
-
-				line.sectionMsg.size = static_cast<uint32_t>(walker - line.data.start - line.sectionMsg.offset);
+				auto sectionStart = walker;
+				walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
+				size_t sectionSize = walker - sectionStart;
 				if (walker < walkerEnd) //the message *can* be the last thing in the line
 				{
-					if ((line.sectionMsg.size < 1) || (walker[-1] != ' ')) //last caracter before '|' must be a space
+					if ((sectionSize < 1) || (walker[-1] != ' ')) //last caracter before '|' must be a space
 						return false;
 
-					line.sectionMsg.size--; //ignore last space
+					sectionSize--; //ignore last space
 					walker++; //ignore '|'
 				}
+
+				if (!line.setSection(LogLine::SectionType::Msg, sectionStart - line.dataStart, sectionSize))
+					return false;
 			}
 
 			//read the params (starting from the message)
@@ -149,8 +141,8 @@ namespace la::flavors
 					return false;
 
 				walker++;
-				line.sectionParams.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionParams.size = static_cast<uint32_t>(walkerEnd - walker); //end of the line
+				if (!line.setSection(LogLine::SectionType::Params, walker - line.dataStart, walkerEnd - walker)) //end of the line
+					return false;
 			}
 
 			//:)
@@ -162,10 +154,10 @@ namespace la::flavors
 	{
 		FlavorsRepo::Info info;
 		info.parser = parse;
+		info.fileParser = FlavorsRepo::processFileData<parse>;
 		info.filesFilter.filter = R"(comlib\.\d\d\d\.log)";
 		info.filesFilter.filterSort = R"(comlib\.(\d\d\d)\.log)";
 		info.filesFilter.reverseSort = true;
-		info.filesFilter.lineIdentification = R"(^\d\d\d\d-\d\d-\d\d \d\d:\d\d:\d\d.\d\d\d \d+ \|[A-Z]{4,} ?\|[\-0-9]{2}\|\w)";
 
 		return info;
 	}
@@ -7,10 +7,10 @@ namespace la::flavors
 {
 	namespace
 	{
-		bool parse(LogLine& line)
+		bool parse(LogLine& line, LogLineHeader& header)
 		{
-			auto walker = line.data.start;
-			auto walkerEnd = line.data.end;
+			auto walker = line.dataStart;
+			auto walkerEnd = line.dataEnd();
 
 			//parse and convert the initial data (timestamp, level, etc.)
 			{
@@ -21,8 +21,8 @@ namespace la::flavors
 
 				//parse timestamp
 				{
-					line.timestamp = FlavorsRepo::translateTimestamp(walker);
-					if (line.timestamp == 0)
+					header.timestamp = FlavorsRepo::translateTimestamp(walker);
+					if (header.timestamp == 0)
 						return false;
 
 					walker += 23;
@@ -36,11 +36,10 @@ namespace la::flavors
 						return false;
 
 					walker++;
-					if (!FlavorsRepo::translateLogLevel(*walker, line.level))
+					if (!FlavorsRepo::translateLogLevel(*walker, header.level))
 						return false;
 
-					while ((walker < walkerEnd) && (walker[0] != '|'))
-						walker++;
+					walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
 					if (walker >= walkerEnd)
 						return false;
@@ -49,61 +48,50 @@ namespace la::flavors
 				}
 			}
 
-			//calculate each section
+			//calculate each section (any spaces at the end of the thread name, tag and method are trimmed)
+			auto trimmedSize = [](const char* start, const char* end) { for (; (end > start) && (end[-1] == ' '); end--); return static_cast<size_t>(end - start); };
 
 			//read the thread name
 			{
-				line.sectionThreadName.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionThreadName.size = 0;
-
-				while ((walker < walkerEnd) && (walker[0] != '|'))
-					walker++;
+				auto sectionStart = walker;
+				walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
 				if (walker >= walkerEnd)
 					return false;
 
-				line.sectionThreadName.size = static_cast<uint32_t>(walker - line.data.start - line.sectionThreadName.offset);
+				if (!line.setSection(LogLine::SectionType::ThreadName, sectionStart - line.dataStart, trimmedSize(sectionStart, walker)))
+					return false;
 
 				walker++; //ignore '|'
 			}
 
 			//read the tag
 			{
-				line.sectionTag.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionTag.size = 0;
+				auto sectionStart = walker;
+				walker = FlavorsRepo::findSeparator(walker, walkerEnd, '|');
 
-				while ((walker < walkerEnd) && (walker[0] != '|'))
-					walker++;
-
-				line.sectionTag.size = static_cast<uint32_t>(walker - line.data.start - line.sectionTag.offset);
+				if (!line.setSection(LogLine::SectionType::Tag, sectionStart - line.dataStart, trimmedSize(sectionStart, walker)))
+					return false;
 
 				walker++; //ignore '|'
 			}
 
 			//read the method
 			{
-				line.sectionMethod.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionMethod.size = 0;
+				auto sectionStart = (walker < walkerEnd) ? walker : walkerEnd;
+				walker = FlavorsRepo::findSeparator(sectionStart, walkerEnd, '|');
 
-				while ((walker < walkerEnd) && (walker[0] != '|'))
-					walker++;
-
-				line.sectionMethod.size = static_cast<uint32_t>(walker - line.data.start - line.sectionMethod.offset);
+				if (!line.setSection(LogLine::SectionType::Method, sectionStart - line.dataStart, trimmedSize(sectionStart, walker)))
+					return false;
 
 				walker++; //ignore '|'
 			}
 
 			//read the message
 			{
-				line.sectionMsg.offset = static_cast<uint16_t>(walker - line.data.start);
-				line.sectionMsg.size = static_cast<uint32_t>(walkerEnd - walker); //end of the line
-			}
-
-			//trim any spaces at the end of each section
-			{
-				for (auto walker = line.data.start + line.sectionThreadName.offset + line.sectionThreadName.size - 1; (line.sectionThreadName.size > 0) && (walker[0] == ' '); line.sectionThreadName.size--, walker--);
-				for (auto walker = line.data.start + line.sectionTag.offset + line.sectionTag.size - 1; (line.sectionTag.size > 0) && (walker[0] == ' '); line.sectionTag.size--, walker--);
-				for (auto walker = line.data.start + line.sectionMethod.offset + line.sectionMethod.size - 1; (line.sectionMethod.size > 0) && (walker[0] == ' '); line.sectionMethod.size--, walker--);
+				auto sectionStart = (walker < walkerEnd) ? walker : walkerEnd;
+				if (!line.setSection(LogLine::SectionType::Msg, sectionStart - line.dataStart, walkerEnd - sectionStart)) //end of the line
+					return false;
 			}
 
 			//:)
@@ -115,10 +103,10 @@ namespace la::flavors
 	{
 		FlavorsRepo::Info info;
 		info.parser = parse;
+		info.fileParser = FlavorsRepo::processFileData<parse>;
 		info.filesFilter.filter = R"(\d\d-(console|msrp|sip|libs|cms)\.log)";
 		info.filesFilter.filterSort = R"((\d\d)-(?:console|msrp|sip|libs|cms)\.log)";
 		info.filesFilter.reverseSort = true;
-		info.filesFilter.lineIdentification = R"(^\d\d\d\d-\d\d-\d\d \d\d:\d\d:\d\d.\d\d\d\|[A-Z]{4,} ?\|[\w -]+\|\w+)";
 
 		return info;
 	}
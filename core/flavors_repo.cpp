@@ -10,8 +10,10 @@
 #include <regex>
 #include <tuple>
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <charconv>
+#include <algorithm>
 #include <filesystem>
 
 namespace la
@@ -26,6 +28,116 @@ namespace la
 
 				//any new types should be placed after this line
 			} };
+
+		//the last "YYYY-MM-DD HH" prefix translated by this thread (lines are mostly ordered, so consecutive timestamps share it)
+		struct TimestampHour
+		{
+			std::array<char, 13> prefix;
+			bool valid{ false };
+			bool linear{ false }; //every second of the hour is localSeconds + offset within the hour (false if a DST change happens in the middle of it)
+			int64_t localSeconds{ 0 }; //seconds since epoch of the hour start, in local time
+			int64_t utcOffset{ 0 };
+		};
+
+		thread_local TimestampHour LastTimestampHour;
+
+		constexpr size_t DetectionSampleSize{ 64 * 1024 }; //how much of the start of a file is read to detect its flavor
+		constexpr size_t DetectionSampleLines{ 32 }; //how many lines of that sample are checked with each flavor
+
+		bool parseDigits(const char* str, size_t count, int& value) noexcept
+		{
+			value = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				if ((str[i] < '0') || (str[i] > '9'))
+					return false;
+
+				value = (value * 10) + (str[i] - '0');
+			}
+
+			return true;
+		}
+
+		int64_t daysFromCivil(int64_t year, int month, int day) noexcept
+		{
+			//days since 1970-01-01 in the proleptic gregorian calendar (years start in March so the leap day is the last one)
+			year -= (month <= 2) ? 1 : 0;
+			auto era = ((year >= 0) ? year : (year - 399)) / 400;
+			auto yearOfEra = year - (era * 400);
+			auto dayOfYear = (((153 * (month + ((month > 2) ? -3 : 9))) + 2) / 5) + day - 1;
+			auto dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+
+			return (era * 146097) + dayOfEra - 719468;
+		}
+
+		int64_t localTimeToUTC(int year, int month, int day, int hour, int minute, int second)
+		{
+			std::tm timeData;
+			std::memset(&timeData, 0, sizeof(std::tm));
+			timeData.tm_year = year - 1900;
+			timeData.tm_mon = month - 1;
+			timeData.tm_mday = day;
+			timeData.tm_hour = hour;
+			timeData.tm_min = minute;
+			timeData.tm_sec = second;
+			timeData.tm_isdst = -1; //let mktime figure out if DST is in effect (otherwise, the result depends on whatever is in the stack)
+
+			return static_cast<int64_t>(std::mktime(&timeData));
+		}
+
+		bool translateTimestampHour(const char* str, TimestampHour& timestampHour)
+		{
+			timestampHour.valid = false;
+
+			int year, month, day, hour;
+			if (!parseDigits(str + 0, 4, year) || !parseDigits(str + 5, 2, month) || !parseDigits(str + 8, 2, day) || !parseDigits(str + 11, 2, hour))
+				return false;
+			if ((year < 1970) || (year > 2099) || (month < 1) || (month > 12) || (day < 1) || (day > 31) || (hour > 23)) //odd dates keep whatever mktime (and chrono) makes of them
+				return false;
+
+			auto hourStart = localTimeToUTC(year, month, day, hour, 0, 0);
+			auto hourEnd = localTimeToUTC(year, month, day, hour, 59, 59);
+
+			std::memcpy(timestampHour.prefix.data(), str, timestampHour.prefix.size());
+			timestampHour.valid = true;
+			timestampHour.linear = (hourStart != -1) && ((hourEnd - hourStart) == 3599);
+			timestampHour.localSeconds = (daysFromCivil(year, month, day) * 86400) + (hour * 3600);
+			timestampHour.utcOffset = timestampHour.localSeconds - hourStart;
+
+			return true;
+		}
+
+		int64_t translateTimestampMktime(const char* str)
+		{
+			std::tm timeData;
+			int timeMilliseconds;
+
+			if (auto [p, ec] = std::from_chars(str + 0, str + 4, timeData.tm_year); ec != std::errc())
+				return 0;
+			if (auto [p, ec] = std::from_chars(str + 5, str + 7, timeData.tm_mon); ec != std::errc())
+				return 0;
+			if (auto [p, ec] = std::from_chars(str + 8, str + 10, timeData.tm_mday); ec != std::errc())
+				return 0;
+
+			if (auto [p, ec] = std::from_chars(str + 11, str + 13, timeData.tm_hour); ec != std::errc())
+				return 0;
+			if (auto [p, ec] = std::from_chars(str + 14, str + 16, timeData.tm_min); ec != std::errc())
+				return 0;
+			if (auto [p, ec] = std::from_chars(str + 17, str + 19, timeData.tm_sec); ec != std::errc())
+				return 0;
+
+			if (auto [p, ec] = std::from_chars(str + 20, str + 23, timeMilliseconds); ec != std::errc())
+				return 0;
+
+			timeData.tm_year = timeData.tm_year - 1900;
+			timeData.tm_mon--;
+			timeData.tm_isdst = -1; //let mktime figure out if DST is in effect (otherwise, the result depends on whatever is in the stack)
+
+			auto timePoint = std::chrono::system_clock::from_time_t(std::mktime(&timeData));
+			auto totalMillis = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch()).count());
+
+			return totalMillis + timeMilliseconds;
+		}
 	}
 
 	bool FlavorsRepo::translateLogLevel(char firstChar, LogLevel& logLevel)
@@ -66,37 +178,29 @@ namespace la
 
 	int64_t FlavorsRepo::translateTimestamp(const char* str)
 	{
-		std::tm timeData;
-		int timeMilliseconds;
+		//the "YYYY-MM-DD HH" prefix is translated once per hour, the rest is just added to it (anything unusual goes through mktime)
+		int minute, second, milliseconds;
+		if (!parseDigits(str + 14, 2, minute) || !parseDigits(str + 17, 2, second) || !parseDigits(str + 20, 3, milliseconds) || (minute > 59) || (second > 59))
+			return translateTimestampMktime(str);
 
-		if (auto [p, ec] = std::from_chars(str + 0, str + 4, timeData.tm_year); ec != std::errc())
-			return 0;
-		if (auto [p, ec] = std::from_chars(str + 5, str + 7, timeData.tm_mon); ec != std::errc())
-			return 0;
-		if (auto [p, ec] = std::from_chars(str + 8, str + 10, timeData.tm_mday); ec != std::errc())
-			return 0;
-
-		if (auto [p, ec] = std::from_chars(str + 11, str + 13, timeData.tm_hour); ec != std::errc())
-			return 0;
-		if (auto [p, ec] = std::from_chars(str + 14, str + 16, timeData.tm_min); ec != std::errc())
-			return 0;
-		if (auto [p, ec] = std::from_chars(str + 17, str + 19, timeData.tm_sec); ec != std::errc())
-			return 0;
-
-		if (auto [p, ec] = std::from_chars(str + 20, str + 23, timeMilliseconds); ec != std::errc())
-			return 0;
-
-		timeData.tm_year = timeData.tm_year - 1900;
-		timeData.tm_mon--;
+		auto& timestampHour = LastTimestampHour;
+		if (!timestampHour.valid || (std::memcmp(timestampHour.prefix.data(), str, timestampHour.prefix.size()) != 0))
+		{
+			if (!translateTimestampHour(str, timestampHour))
+				return translateTimestampMktime(str);
+		}
 
-		auto timePoint = std::chrono::system_clock::from_time_t(std::mktime(&timeData));
-		auto totalMillis = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch()).count());
+		if (!timestampHour.linear)
+			return translateTimestampMktime(str);
 
-		return totalMillis + timeMilliseconds;
+		return ((timestampHour.localSeconds - timestampHour.utcOffset + (minute * 60) + second) * 1000) + milliseconds;
 	}
 
 	std::vector<std::string> FlavorsRepo::listFolderFiles(Type type, std::string_view folderPath)
 	{
+		if (type == Type::Unknown)
+			type = retrieveFolderType(folderPath);
+
 		std::vector<std::string> files;
 
 		iterateFolderFiles(type, folderPath, [&files](std::string filePath)
@@ -175,116 +279,174 @@ namespace la
 		if (!std::filesystem::is_regular_file(path))
 			return Type::Unknown;
 
-		std::string fileLine;
+		std::string sample(DetectionSampleSize, '\0');
 		{
-			std::ifstream in(path.native().c_str());
-			std::getline(in, fileLine);
+			std::ifstream in(path.native().c_str(), std::ios::binary);
+			in.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+			sample.resize(static_cast<size_t>(in.gcount()));
 		}
 
-		if (fileLine.empty())
+		return retrieveDataType(sample.data(), sample.size());
+	}
+
+	FlavorsRepo::Type FlavorsRepo::retrieveDataType(const void* data, size_t dataSize)
+	{
+		if (!data || (dataSize <= 0))
 			return Type::Unknown;
 
-		for (const auto& [flavorType, flavorInfo] : Flavors)
+		//the flavor whose parser accepts more of the sampled lines wins (lines no parser accepts are just multiline content)
+		std::array<size_t, Flavors.size()> matches{ };
+		{
+			LinesScanner scanner{ data, dataSize };
+			LinesScanner::Span span;
+
+			for (size_t i = 0; (i < DetectionSampleLines) && scanner.nextLine(span); i++)
+			{
+				for (size_t j = 0; j < Flavors.size(); j++)
+				{
+					LogLine line;
+					std::memset(&line, 0, sizeof(LogLine));
+					line.dataStart = span.start;
+					line.setDataEnd(span.end);
+
+					LogLineHeader header{ 0, 0, LogLevel::Fatal };
+					if (std::get<1>(Flavors[j]).parser(line, header))
+						matches[j]++;
+				}
+			}
+		}
+
+		auto it = std::max_element(matches.begin(), matches.end());
+		if (*it == 0)
+			return Type::Unknown;
+
+		return std::get<0>(Flavors[static_cast<size_t>(it - matches.begin())]);
+	}
+
+	FlavorsRepo::Type FlavorsRepo::retrieveFolderType(std::string_view folderPath)
+	{
+		//the flavor with more files wins (on a tie, the first known type)
+		Type type{ Type::Unknown };
+		size_t typeFiles{ 0 };
+
+		for (const auto& [flavorType, files] : groupFolderFiles(folderPath))
 		{
-			if (flavorInfo.filesFilter.lineIdentification.empty())
+			if (files.size() <= typeFiles)
 				continue;
 
-			std::smatch matches;
-			if (std::regex_match(fileLine, matches, std::regex{ std::string{ flavorInfo.filesFilter.lineIdentification } }))
-				return flavorType;
+			type = flavorType;
+			typeFiles = files.size();
 		}
 
-		return Type::Unknown;
+		return type;
 	}
 
-	bool FlavorsRepo::processLineData(Type type, std::string_view line, LogLine& out)
+	std::vector<std::tuple<FlavorsRepo::Type, std::vector<std::string>>> FlavorsRepo::groupFolderFiles(std::string_view folderPath)
+	{
+		std::vector<std::tuple<Type, std::vector<std::string>>> groups;
+
+		for (const auto& knownFlavor : Flavors)
+		{
+			auto type = std::get<0>(knownFlavor);
+
+			//only the files named like the flavor are candidates (they would not be loaded otherwise), but one with the logs of another flavor is part of its group
+			std::vector<std::string> files;
+			iterateFolderFiles(type, folderPath, [&files, type](std::string filePath)
+			{
+				if (isGroupFile(type, retrieveFileType(filePath)))
+					files.push_back(std::move(filePath));
+			});
+
+			if (!files.empty())
+				groups.emplace_back(type, std::move(files));
+		}
+
+		return groups;
+	}
+
+	bool FlavorsRepo::processLineData(Type type, std::string_view line, LogLine& out, LogLineHeader& outHeader)
 	{
 		if ((type == Type::Unknown) || line.empty())
 			return false;
 
 		std::memset(&out, 0, sizeof(LogLine));
-		out.data.start = line.data();
-		out.data.end = out.data.start + line.size();
-		out.level = LogLevel::Fatal;
+		out.dataStart = line.data();
+		out.setDataEnd(out.dataStart + line.size());
+		outHeader = { 0, 0, LogLevel::Fatal };
 
 		for (const auto& [flavorType, flavorInfo] : Flavors)
 		{
 			if (flavorType != type)
 				continue;
 
-			return flavorInfo.parser(out);
+			return flavorInfo.parser(out, outHeader);
 		}
 
 		return false;
 	}
 
-	size_t FlavorsRepo::processFileData(Type type, const void* data, size_t dataSize, std::vector<LogLine>& out)
+	size_t FlavorsRepo::processFileData(Type type, const void* data, size_t dataSize, std::vector<LogLine>& out, std::vector<LogLineHeader>& outHeaders)
+	{
+		return processFileData(type, data, dataSize, out, outHeaders, nullptr);
+	}
+
+	size_t FlavorsRepo::processFileData(Type type, const void* data, size_t dataSize, std::vector<LogLine>& out, std::vector<LogLineHeader>& outHeaders, const char** leadingContentEnd)
 	{
 		if (!data || (dataSize <= 0) || (type == Type::Unknown))
 			return 0;
 
-		std::function<bool(LogLine&)> parser;
+		//each flavor has its own instantiation (with the parser inlined), the type just selects it
 		for (const auto& [flavorType, flavorInfo] : Flavors)
 		{
 			if (flavorType != type)
 				continue;
 
-			parser = flavorInfo.parser;
-			break;
+			if (!flavorInfo.fileParser)
+				return 0;
+
+			return flavorInfo.fileParser(data, dataSize, out, outHeaders, leadingContentEnd);
 		}
-		if (!parser)
-			return 0;
 
-		auto walker = reinterpret_cast<const char*>(data);
-		auto walkerEnd = walker + dataSize;
+		return 0;
+	}
 
-		size_t numLines{ 0 };
-		while (walker < walkerEnd)
-		{
-			LogLine line;
-			std::memset(&line, 0, sizeof(LogLine));
-			line.data.start = walker;
-			line.data.end = line.data.start;
-			line.level = LogLevel::Fatal;
+	void FlavorsRepo::appendMultilineContent(LogLine& line, const char* contentEnd) noexcept
+	{
+		auto msgOffset = line.sectionOffset(LogLine::SectionType::Msg);
+		if ((line.sectionSize(LogLine::SectionType::Params) <= 0) && ((line.dataStart + msgOffset + line.sectionSize(LogLine::SectionType::Msg)) == line.dataEnd()))
+			line.setSectionSize(LogLine::SectionType::Msg, static_cast<size_t>(contentEnd - line.dataStart) - msgOffset); //also append to the msg section
+		line.setDataEnd(contentEnd);
+	}
 
-			//move to next line
-			{
-				while ((walker < walkerEnd) && (walker[0] != '\n') && (walker[0] != '\r'))
-					walker++;
+	std::vector<std::string_view> FlavorsRepo::splitFileData(const void* data, size_t dataSize, size_t chunkSize)
+	{
+		std::vector<std::string_view> chunks;
 
-				line.data.end = walker;
+		if (!data || (dataSize <= 0))
+			return chunks;
 
-				if ((walker < walkerEnd) && ((walker[0] == '\n') || (walker[0] == '\r')))
-					walker++;
-			}
+		if (chunkSize <= 0)
+			chunkSize = dataSize;
 
-			//consume '\0's for the next line
-			while ((walker < walkerEnd) && (walker[0] == '\0'))
-				walker++;
+		auto walker = reinterpret_cast<const char*>(data);
+		auto walkerEnd = walker + dataSize;
 
-			//try to read a valid line
-			auto success = parser(line);
+		while (walker < walkerEnd)
+		{
+			auto chunkStart = walker;
+			walker = (static_cast<size_t>(walkerEnd - walker) > chunkSize) ? (walker + chunkSize) : walkerEnd;
 
-			//we assume that an invalid line is actually content belonging to the previous line (multiline content)
-			if (!success)
+			//a chunk must finish exactly where processFileData would start a new line (after the line break and any '\0's)
 			{
-				if (!out.empty())
-				{
-					auto& last = out.back();
-
-					if ((last.sectionParams.size <= 0) && ((last.data.start + last.sectionMsg.offset + last.sectionMsg.size) == last.data.end))
-						last.sectionMsg.size = static_cast<uint32_t>(line.data.end - last.data.start - last.sectionMsg.offset); //also append to the msg section
-					last.data.end = line.data.end;
-				}
-
-				continue;
+				LinesScanner scanner{ walker, static_cast<size_t>(walkerEnd - walker) };
+				LinesScanner::Span span;
+				scanner.nextLine(span);
+				walker = scanner.position();
 			}
 
-			//new line!
-			out.push_back(line);
-			numLines++;
+			chunks.emplace_back(chunkStart, static_cast<size_t>(walker - chunkStart));
 		}
 
-		return numLines;
+		return chunks;
 	}
 }
@@ -3,9 +3,12 @@
 #define LA_FLAVORS_REPO_HPP
 
 #include "log_line.hpp"
+#include "lines_scanner.hpp"
 
+#include <tuple>
 #include <string>
 #include <vector>
+#include <cstring>
 #include <functional>
 #include <string_view>
 
@@ -27,14 +30,14 @@ namespace la
 
 		struct Info
 		{
-			std::function<bool(LogLine&)> parser;
+			std::function<bool(LogLine&, LogLineHeader&)> parser;
+			size_t(*fileParser)(const void* data, size_t dataSize, std::vector<LogLine>& out, std::vector<LogLineHeader>& outHeaders, const char** leadingContentEnd){ nullptr }; //processFileData instantiated with the parser
 
 			struct
 			{
 				std::string_view filter; //what types of files are valid
 				std::string_view filterSort; //what part of the file should be used to order said file
 				bool reverseSort{ false }; //reverse the order of files
-				std::string_view lineIdentification; //regex to identify if the first line of a file corresponds to this type
 			} filesFilter;
 		};
 
@@ -42,15 +45,92 @@ namespace la
 		static bool translateLogLevel(char firstChar, LogLevel& logLevel);
 		static int64_t translateTimestamp(const char* str);
 
+		//same as walking until the separator (or the end of the line) but using the vectorized memchr of the runtime
+		static const char* findSeparator(const char* walker, const char* walkerEnd, char separator) noexcept
+		{
+			if (walker >= walkerEnd)
+				return walker;
+
+			auto found = static_cast<const char*>(std::memchr(walker, separator, static_cast<size_t>(walkerEnd - walker)));
+			return (found != nullptr) ? found : walkerEnd;
+		}
+
 	public:
 		static std::vector<std::string> listFolderFiles(Type type, std::string_view folderPath);
 
+		//the files of the flavor in the folder, in order (the ones named like the flavor)
 		static size_t iterateFolderFiles(Type type, std::string_view folderPath, const std::function<void(std::string filePath)>& cb);
 
+		//the flavor is detected from the content: a sample of the first lines is checked with the parser of each flavor
 		static Type retrieveFileType(std::string_view filePath);
+		static Type retrieveDataType(const void* data, size_t dataSize);
+		static Type retrieveFolderType(std::string_view folderPath);
+
+		//the files named like each flavor, without the ones whose content is of another flavor (empty files, or the ones starting with multiline content, are kept)
+		static std::vector<std::tuple<Type, std::vector<std::string>>> groupFolderFiles(std::string_view folderPath);
+
+		static bool isGroupFile(Type type, Type fileType) noexcept
+		{
+			return ((fileType == Type::Unknown) || (fileType == type));
+		}
+
+		//the header of each line is given apart from it (in "outHeaders", with the same indices as "out")
+		static bool processLineData(Type type, std::string_view line, LogLine& out, LogLineHeader& outHeader);
+		static size_t processFileData(Type type, const void* data, size_t dataSize, std::vector<LogLine>& out, std::vector<LogLineHeader>& outHeaders);
+		static size_t processFileData(Type type, const void* data, size_t dataSize, std::vector<LogLine>& out, std::vector<LogLineHeader>& outHeaders, const char** leadingContentEnd);
+
+		template<bool(*TParser)(LogLine&, LogLineHeader&)>
+		static size_t processFileData(const void* data, size_t dataSize, std::vector<LogLine>& out, std::vector<LogLineHeader>& outHeaders, const char** leadingContentEnd)
+		{
+			if (!data || (dataSize <= 0))
+				return 0;
+
+			size_t numLines{ 0 };
+			auto firstLineIndex = out.size();
+
+			//lines are delimited in batches, ahead of parsing them
+			LinesScanner scanner{ data, dataSize };
+			LinesScanner::Batch batch;
+
+			while (auto batchSize = scanner.nextBatch(batch))
+			{
+				for (size_t i = 0; i < batchSize; i++)
+				{
+					LogLine line;
+					std::memset(&line, 0, sizeof(LogLine));
+					line.dataStart = batch[i].start;
+					line.setDataEnd(batch[i].end);
+
+					LogLineHeader header{ 0, 0, LogLevel::Fatal };
+
+					//try to read a valid line
+					auto success = TParser(line, header);
+
+					//we assume that an invalid line is actually content belonging to the previous line (multiline content)
+					if (!success)
+					{
+						//content before our first valid line is reported back instead (if requested), as the previous line may not be known yet
+						if ((out.size() <= firstLineIndex) && leadingContentEnd)
+							*leadingContentEnd = line.dataEnd();
+						else if (!out.empty())
+							appendMultilineContent(out.back(), line.dataEnd());
+
+						continue;
+					}
+
+					//new line!
+					out.push_back(line);
+					outHeaders.push_back(header);
+					numLines++;
+				}
+			}
+
+			return numLines;
+		}
+
+		static void appendMultilineContent(LogLine& line, const char* contentEnd) noexcept;
 
-		static bool processLineData(Type type, std::string_view line, LogLine& out);
-		static size_t processFileData(Type type, const void* data, size_t dataSize, std::vector<LogLine>& out);
+		static std::vector<std::string_view> splitFileData(const void* data, size_t dataSize, size_t chunkSize);
 	};
 }
 
@@ -0,0 +1,94 @@
+#include "http_request_index.hpp"
+
+#include "line_events.hpp"
+#include "lines_tools.hpp"
+
+#include <charconv>
+#include <string_view>
+
+namespace la
+{
+	namespace
+	{
+		//the id of params which start with "<paramName>=X;" followed by "paramsNext"
+		std::optional<int64_t> parseRequestId(std::string_view params, std::string_view paramName, std::string_view paramsNext)
+		{
+			if ((params.size() <= paramName.size()) || (params.substr(0, paramName.size()) != paramName) || (params[paramName.size()] != '='))
+				return std::nullopt;
+
+			int64_t httpRequestId;
+			auto [p, ec] = std::from_chars(params.data() + paramName.size() + 1, params.data() + params.size(), httpRequestId);
+			if ((ec != std::errc()) || (p == (params.data() + params.size())) || (*p != ';'))
+				return std::nullopt;
+
+			auto rest = params.substr(static_cast<size_t>(p + 1 - params.data()));
+			if (rest.substr(0, paramsNext.size()) != paramsNext)
+				return std::nullopt;
+
+			return httpRequestId;
+		}
+	}
+
+	const std::vector<HTTPRequestIndex::Event>& HTTPRequestIndex::requestEvents(int64_t httpRequestId) const
+	{
+		static const std::vector<Event> NoEvents;
+
+		auto itRequest = m_requests.find(httpRequestId);
+		return (itRequest != m_requests.end()) ? itRequest->second : NoEvents;
+	}
+
+	std::optional<HTTPRequestIndex::Event> HTTPRequestIndex::findFirst(int64_t httpRequestId, EventType type, size_t lineIndexStart, size_t lineIndexEnd) const
+	{
+		return LineEvents::findFirst(requestEvents(httpRequestId), type, lineIndexStart, lineIndexEnd);
+	}
+
+	std::optional<HTTPRequestIndex::Event> HTTPRequestIndex::findLast(int64_t httpRequestId, EventType type, size_t lineIndexEnd) const
+	{
+		return LineEvents::findLast(requestEvents(httpRequestId), type, lineIndexEnd);
+	}
+
+	void HTTPRequestIndex::truncate(size_t numLines)
+	{
+		if (numLines >= m_numLines)
+			return;
+
+		LineEvents::truncate(m_requests, numLines);
+
+		m_numLines = numLines;
+	}
+
+	void HTTPRequestIndex::extend(const LinesTools& linesTools)
+	{
+		auto numLines = linesTools.lines().size();
+		if (m_numLines >= numLines)
+			return;
+
+		LinesTools::FilterCollection filter{
+			LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.HTTP") };
+
+		//the name is looked up on each extension (the first "request" params may be in the new lines)
+		linesTools.windowIterate({ m_numLines, numLines }, filter, [this, &linesTools, paramRequest = linesTools.paramNames().find("request")](size_t, LogLine line, size_t lineIndex)
+		{
+			if (line.checkSectionMethod<LogLine::MatchType::Exact>("curlDebugCallback"))
+			{
+				int64_t httpRequestId;
+				if (linesTools.paramExtractAs<int64_t>(lineIndex, paramRequest, httpRequestId))
+					m_requests[httpRequestId].push_back({ lineIndex, EventType::Debug });
+			}
+			else if (line.checkSectionMethod<LogLine::MatchType::Exact>("asioProcessDispatcher") && line.checkSectionMsg<LogLine::MatchType::Exact>("request new"))
+			{
+				if (auto httpRequestId = parseRequestId(line.getSectionParams(), "id", " method="); httpRequestId.has_value())
+					m_requests[*httpRequestId].push_back({ lineIndex, EventType::New });
+			}
+			else if (line.checkSectionMethod<LogLine::MatchType::Exact>("asioProcessTerminated") && line.checkSectionMsg<LogLine::MatchType::Exact>("request finished"))
+			{
+				if (auto httpRequestId = parseRequestId(line.getSectionParams(), "requestId", " result="); httpRequestId.has_value())
+					m_requests[*httpRequestId].push_back({ lineIndex, EventType::Finished });
+			}
+
+			return true;
+		});
+
+		m_numLines = numLines;
+	}
+}
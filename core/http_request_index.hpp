@@ -0,0 +1,59 @@
+#ifndef LA_HTTP_REQUEST_INDEX_HPP
+#define LA_HTTP_REQUEST_INDEX_HPP
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace la
+{
+	class LinesTools;
+
+	//the lines of the COMLib HTTP requests ("COMLib.HTTP" lines), by request id, found in a single pass over the lines
+	//request ids are reused by other executions of the app, so the lines of an id are usually looked up in a range of lines
+	class HTTPRequestIndex final
+	{
+	public:
+		enum class EventType : uint8_t
+		{
+			New, //"asioProcessDispatcher | request new | id=X; method="
+			Debug, //"curlDebugCallback" with "request=X"
+			Finished //"asioProcessTerminated | request finished | requestId=X; result="
+		};
+
+		struct Event
+		{
+			size_t lineIndex;
+			EventType type;
+		};
+
+	public:
+		//the lines [0, numLines()) are indexed
+		size_t numLines() const noexcept
+		{
+			return m_numLines;
+		}
+
+		//the events of a request, in order (empty when it has none)
+		const std::vector<Event>& requestEvents(int64_t httpRequestId) const;
+
+		//the first event of a request with the type, in [lineIndexStart, lineIndexEnd)
+		std::optional<Event> findFirst(int64_t httpRequestId, EventType type, size_t lineIndexStart, size_t lineIndexEnd) const;
+
+		//the last event of a request with the type, in [0, lineIndexEnd)
+		std::optional<Event> findLast(int64_t httpRequestId, EventType type, size_t lineIndexEnd) const;
+
+		//the events from "numLines" on are removed
+		void truncate(size_t numLines);
+
+		//indexes the lines after the ones already indexed
+		void extend(const LinesTools& linesTools);
+
+	private:
+		size_t m_numLines{ 0 };
+		std::unordered_map<int64_t, std::vector<Event>> m_requests;
+	};
+}
+
+#endif
@@ -13,13 +13,14 @@ namespace la
 		void inspectExecutions(InspectorsRepo::IResultCtx& inspectionCtx, const LinesTools& linesTools)
 		{
 			auto& lines = linesTools.lines();
+			auto& timestamps = linesTools.timestamps();
 
 			for (const auto& range : CommandsCOMLibUtils::executionsRanges(linesTools))
 			{
 				if (range.empty())
 					continue;
 
-				inspectionCtx.addExecution(lines[range.start].toStr(), lines[range.start].timestamp, lines[range.end - 1].timestamp, range);
+				inspectionCtx.addExecution(lines[range.start].toStr(), timestamps[range.start], timestamps[range.end - 1], range);
 			}
 		}
 
@@ -48,14 +49,15 @@ namespace la
 						LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib"),
 						LinesTools::FilterParam<LinesTools::FilterType::Msg, std::string_view, LogLine::MatchType::StartsWith>("****** ") };
 
-			std::regex regMatch(R"(\*\*\*\*\*\* \w* \d\d \d\d\d\d \d\d:\d\d:\d\d \* .+ \* \w+)");
+			RegexSearcher regMatch{ R"(\*\*\*\*\*\* \w* \d\d \d\d\d\d \d\d:\d\d:\d\d \* .+ \* \w+)" };
 
 			std::set<std::string_view> buildInfos;
 			linesTools.windowIterate({ 0, lines.size() }, filter, [&regMatch, &buildInfos](size_t, LogLine line, size_t)
 			{
 				//just the one at the start of the executions (ignore the ones printed after a log rotation)
-				if (std::regex_match(line.data.start + line.sectionMsg.offset, line.data.start + line.sectionMsg.offset + line.sectionMsg.size, regMatch))
-					buildInfos.insert(line.getSectionMsg());
+				auto msg = line.getSectionMsg();
+				if (regMatch.match(msg.data(), msg.data() + msg.size()))
+					buildInfos.insert(msg);
 
 				return true;
 			});
@@ -71,13 +73,13 @@ namespace la
 			LinesTools::FilterCollection filter{
 						LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.PJSIP") };
 
-			std::regex regex{ R"(User-Agent: (\S+\/\S+ \S+\/\S+ \S+\/\S+ \S+\/\S+))", std::regex::ECMAScript | std::regex::icase };
+			RegexSearcher regex{ R"(User-Agent: (\S+\/\S+ \S+\/\S+ \S+\/\S+ \S+\/\S+))", std::regex::ECMAScript | std::regex::icase };
 
 			std::set<std::string> userAgents;
 			linesTools.windowIterate({ 0, lines.size() }, filter, [&regex, &userAgents](size_t, LogLine line, size_t)
 			{
 				std::cmatch matches;
-				if (std::regex_search(line.data.start + line.sectionMsg.offset, line.data.end, matches, regex))
+				if (regex.search(line.getSectionMsg().data(), line.dataEnd(), matches))
 					userAgents.insert(matches[1].str());
 
 				return true;
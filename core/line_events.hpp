@@ -0,0 +1,69 @@
+#ifndef LA_LINE_EVENTS_HPP
+#define LA_LINE_EVENTS_HPP
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+
+namespace la
+{
+	//the lookups shared by the indexes of events found in the lines (tasks, HTTP requests, ...): lists of events in line order, with a "lineIndex" and a "type"
+	struct LineEvents
+	{
+		//the first event with the type, in [lineIndexStart, lineIndexEnd)
+		template<class TEvent, class TEventType>
+		static std::optional<TEvent> findFirst(const std::vector<TEvent>& events, TEventType type, size_t lineIndexStart, size_t lineIndexEnd)
+		{
+			auto itEvent = lowerBound(events, lineIndexStart);
+			for (; (itEvent != events.end()) && (itEvent->lineIndex < lineIndexEnd); itEvent++)
+			{
+				if (itEvent->type == type)
+					return *itEvent;
+			}
+
+			return std::nullopt;
+		}
+
+		//the last event with the type, in [0, lineIndexEnd)
+		template<class TEvent, class TEventType>
+		static std::optional<TEvent> findLast(const std::vector<TEvent>& events, TEventType type, size_t lineIndexEnd)
+		{
+			auto itEvent = lowerBound(events, lineIndexEnd);
+			while (itEvent != events.begin())
+			{
+				itEvent--;
+				if (itEvent->type == type)
+					return *itEvent;
+			}
+
+			return std::nullopt;
+		}
+
+		//the first event in [lineIndex, ...)
+		template<class TEvent>
+		static typename std::vector<TEvent>::const_iterator lowerBound(const std::vector<TEvent>& events, size_t lineIndex)
+		{
+			return std::lower_bound(events.begin(), events.end(), lineIndex, [](const TEvent& event, size_t index) { return (event.lineIndex < index); });
+		}
+
+		//the events from "numLines" on are removed from every list of the map (and the lists left empty with them)
+		template<class TMap>
+		static void truncate(TMap& eventsMap, size_t numLines)
+		{
+			//the events are in order, so the removed ones are at the end of each list
+			for (auto itEvents = eventsMap.begin(); itEvents != eventsMap.end(); )
+			{
+				auto& events = itEvents->second;
+				while (!events.empty() && (events.back().lineIndex >= numLines))
+					events.pop_back();
+
+				if (events.empty())
+					itEvents = eventsMap.erase(itEvents);
+				else
+					itEvents++;
+			}
+		}
+	};
+}
+
+#endif
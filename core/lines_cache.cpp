@@ -0,0 +1,477 @@
+#include "lines_cache.hpp"
+
+#include "utils.hpp"
+#include "mmap_file.hpp"
+#include "files_repo.hpp"
+#include "lines_tools.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+namespace la
+{
+	namespace
+	{
+		//any change to the format (or to how lines are parsed) must also change the version
+		constexpr uint32_t IndexVersion{ 3 };
+		constexpr std::array<char, 8> IndexMagic{ 'L', 'A', 'I', 'N', 'D', 'E', 'X', '\0' };
+		constexpr std::array<char, 8> SearchIndexMagic{ 'L', 'A', 'S', 'E', 'A', 'R', 'C', 'H' }; //has the same header and files (it's only valid for the lines of the index)
+
+		constexpr size_t IndexHashSize{ 4096 }; //how much of the start and of the end of each file is hashed
+		constexpr size_t IndexBlockSize{ 64 * 1024 }; //lines converted at a time (by each worker or before writing them)
+
+		struct IndexHeader
+		{
+			std::array<char, 8> magic;
+			uint32_t version;
+			uint32_t lineSize;
+			uint64_t numLines;
+			uint32_t numFiles;
+			uint32_t fileNameFilterSize;
+			uint8_t flavor;
+			uint8_t reserved[7];
+		};
+
+		struct IndexFile
+		{
+			uint64_t size;
+			int64_t modifiedTime;
+			uint64_t contentHash;
+			uint64_t numLines; //lines starting in this file
+			uint32_t nameSize;
+			uint32_t reserved;
+		};
+
+		struct IndexLine
+		{
+			int64_t timestamp;
+			uint64_t dataOffset; //from the start of the file
+			uint32_t dataSize; //a line is always inside its file
+			int32_t threadId;
+			LogLine::Sections sections;
+			LogLevel level;
+		};
+
+		static_assert(std::is_trivial_v<IndexHeader> && std::is_trivial_v<IndexFile> && std::is_trivial_v<IndexLine>);
+
+		constexpr std::array<LogLine::SectionType, 5> LineSections{ LogLine::SectionType::ThreadName, LogLine::SectionType::Tag, LogLine::SectionType::Method, LogLine::SectionType::Msg, LogLine::SectionType::Params };
+
+		struct FileKey
+		{
+			IndexFile info;
+			std::string name;
+
+			const char* data;
+			const char* dataEnd;
+		};
+
+		uint64_t hashContent(const char* data, size_t size) noexcept
+		{
+			//FNV-1a of the start and the end of the content
+			uint64_t hash{ 14695981039346656037ull };
+			auto hashRange = [&hash](const char* start, const char* end)
+			{
+				for (; start < end; start++)
+					hash = (hash ^ static_cast<uint8_t>(*start)) * 1099511628211ull;
+			};
+
+			auto hashSize = std::min(size, IndexHashSize);
+			hashRange(data, data + hashSize);
+			hashRange(data + size - hashSize, data + size);
+
+			return hash;
+		}
+
+		bool genFilesKeys(const FilesRepo& repoFiles, std::vector<FileKey>& filesKeys)
+		{
+			bool valid{ true };
+
+			repoFiles.iterateFilesPaths([&filesKeys, &valid](std::string_view filePath, const void* data, size_t size)
+			{
+				auto path = std::filesystem::u8path(filePath);
+
+				std::error_code ec;
+				auto modifiedTime = std::filesystem::last_write_time(path, ec);
+				if (ec)
+				{
+					valid = false;
+					return;
+				}
+
+				FileKey fileKey;
+				std::memset(&fileKey.info, 0, sizeof(IndexFile));
+				fileKey.info.size = size;
+				fileKey.info.modifiedTime = static_cast<int64_t>(modifiedTime.time_since_epoch().count());
+				fileKey.info.contentHash = hashContent(reinterpret_cast<const char*>(data), size);
+				fileKey.name = path.filename().u8string();
+				fileKey.info.nameSize = static_cast<uint32_t>(fileKey.name.size());
+				fileKey.data = reinterpret_cast<const char*>(data);
+				fileKey.dataEnd = fileKey.data + size;
+
+				filesKeys.push_back(std::move(fileKey));
+			});
+
+			return valid && !filesKeys.empty();
+		}
+
+		struct IndexReader
+		{
+			const char* data;
+			const char* walker;
+			const char* walkerEnd;
+
+			bool read(void* out, size_t size)
+			{
+				if (static_cast<size_t>(walkerEnd - walker) < size)
+					return false;
+
+				std::memcpy(out, walker, size);
+				walker += size;
+				return true;
+			}
+
+			bool align()
+			{
+				walker = data + (((walker - data) + 7) & ~static_cast<ptrdiff_t>(7));
+				return (walker <= walkerEnd);
+			}
+		};
+
+		//everything must match: the format, the flavor, how the files were selected and the files themselves
+		bool readIndexStart(IndexReader& reader, const std::array<char, 8>& magic, const FilesRepo& repoFiles, const std::vector<FileKey>& filesKeys, IndexHeader& header, std::vector<IndexFile>& files)
+		{
+			if (!reader.read(&header, sizeof(IndexHeader)))
+				return false;
+			if ((header.magic != magic) || (header.version != IndexVersion) || (header.lineSize != sizeof(IndexLine)))
+				return false;
+			if ((header.flavor != static_cast<uint8_t>(repoFiles.flavor())) || (header.numFiles != filesKeys.size()))
+				return false;
+
+			{
+				std::string fileNameFilter(header.fileNameFilterSize, '\0');
+				if (!reader.read(fileNameFilter.data(), fileNameFilter.size()) || (fileNameFilter != repoFiles.fileNameFilterRegex()))
+					return false;
+			}
+
+			for (auto& fileKey : filesKeys)
+			{
+				IndexFile file;
+				if (!reader.read(&file, sizeof(IndexFile)))
+					return false;
+				if ((file.size != fileKey.info.size) || (file.modifiedTime != fileKey.info.modifiedTime) || (file.contentHash != fileKey.info.contentHash) || (file.nameSize != fileKey.info.nameSize))
+					return false;
+
+				std::string name(file.nameSize, '\0');
+				if (!reader.read(name.data(), name.size()) || (name != fileKey.name))
+					return false;
+
+				files.push_back(file);
+			}
+
+			return reader.align();
+		}
+
+		void writeIndexStart(std::ostream& out, const std::array<char, 8>& magic, const FilesRepo& repoFiles, const std::vector<FileKey>& filesKeys, uint64_t numLines)
+		{
+			IndexHeader header;
+			std::memset(&header, 0, sizeof(IndexHeader));
+			header.magic = magic;
+			header.version = IndexVersion;
+			header.lineSize = sizeof(IndexLine);
+			header.numLines = numLines;
+			header.numFiles = static_cast<uint32_t>(filesKeys.size());
+			header.fileNameFilterSize = static_cast<uint32_t>(repoFiles.fileNameFilterRegex().size());
+			header.flavor = static_cast<uint8_t>(repoFiles.flavor());
+
+			size_t headerSize{ 0 };
+			auto write = [&out, &headerSize](const void* data, size_t size)
+			{
+				out.write(reinterpret_cast<const char*>(data), size);
+				headerSize += size;
+			};
+
+			write(&header, sizeof(IndexHeader));
+			write(repoFiles.fileNameFilterRegex().data(), repoFiles.fileNameFilterRegex().size());
+
+			for (const auto& fileKey : filesKeys)
+			{
+				write(&fileKey.info, sizeof(IndexFile));
+				write(fileKey.name.data(), fileKey.name.size());
+			}
+
+			std::array<char, 8> padding{ 0 };
+			write(padding.data(), ((headerSize + 7) & ~static_cast<size_t>(7)) - headerSize);
+		}
+
+		//next to the files (in the folder, or beside the file), or in the cache folder with a name from the path of the files (so repos can share it)
+		std::filesystem::path cacheFilePath(const FilesRepo& repoFiles, std::string_view cacheFolderPath, std::string_view extension)
+		{
+			auto path = std::filesystem::u8path(repoFiles.path());
+
+			if (cacheFolderPath.empty())
+			{
+				if (repoFiles.pathIsFolder())
+					return path / std::filesystem::u8path(extension);
+
+				path += std::filesystem::u8path(extension);
+				return path;
+			}
+
+			std::error_code ec;
+			auto absolutePath = std::filesystem::absolute(path, ec);
+			if (!ec)
+				path = absolutePath.lexically_normal();
+
+			auto fullPath = path.u8string();
+			auto name = (path.has_filename() ? path.filename() : path.parent_path().filename()).u8string();
+
+			char pathHash[17];
+			std::snprintf(pathHash, sizeof(pathHash), "%016llx", static_cast<unsigned long long>(hashContent(fullPath.data(), fullPath.size())));
+
+			return std::filesystem::u8path(cacheFolderPath) / std::filesystem::u8path(name + "." + pathHash + std::string{ extension });
+		}
+
+		//the index is written to a temporary file, which then replaces it in one go (so a partial index is never read)
+		bool writeIndex(const std::filesystem::path& filePath, const std::function<bool(std::ostream& out)>& cbWrite)
+		{
+			//a cache folder is created when the first index is stored in it
+			if (filePath.has_parent_path())
+			{
+				std::error_code ec;
+				std::filesystem::create_directories(filePath.parent_path(), ec);
+			}
+
+			auto tmpFilePath = filePath;
+			tmpFilePath += ".tmp";
+
+			{
+				std::ofstream out(tmpFilePath.native().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!out.is_open())
+					return false;
+
+				auto written = cbWrite(out);
+
+				out.close();
+				if (!written || !out)
+				{
+					std::error_code ec;
+					std::filesystem::remove(tmpFilePath, ec);
+					return false;
+				}
+			}
+
+			std::error_code ec;
+			std::filesystem::rename(tmpFilePath, filePath, ec);
+			if (ec)
+			{
+				std::filesystem::remove(tmpFilePath, ec);
+				return false;
+			}
+
+			return true;
+		}
+	}
+
+	std::string LinesCache::indexPath(const FilesRepo& repoFiles, std::string_view cacheFolderPath)
+	{
+		return cacheFilePath(repoFiles, cacheFolderPath, ".la_lines_index").u8string();
+	}
+
+	bool LinesCache::load(const FilesRepo& repoFiles, std::string_view cacheFolderPath, std::vector<LogLine>& lines, LinesTools& linesTools)
+	{
+		std::vector<FileKey> filesKeys;
+		if (!genFilesKeys(repoFiles, filesKeys))
+			return false;
+
+		MemoryMappedFile index{ indexPath(repoFiles, cacheFolderPath) };
+		if (!index)
+			return false;
+
+		IndexReader reader{ index.dataAs<const char*>(), index.dataAs<const char*>(), index.dataAs<const char*>() + index.size() };
+
+		IndexHeader header;
+		std::vector<IndexFile> files;
+		if (!readIndexStart(reader, IndexMagic, repoFiles, filesKeys, header, files))
+			return false;
+
+		std::vector<size_t> filesFirstLine{ 0 };
+		for (const auto& file : files)
+			filesFirstLine.push_back(filesFirstLine.back() + static_cast<size_t>(file.numLines));
+
+		if ((filesFirstLine.back() != header.numLines) || ((static_cast<size_t>(reader.walkerEnd - reader.walker) / sizeof(IndexLine)) < header.numLines))
+			return false;
+
+		//rebase the lines to where the files are mapped now
+		auto indexLines = reader.walker;
+		auto numLines = static_cast<size_t>(header.numLines);
+		lines.resize(numLines);
+		linesTools.resizeHeaders(numLines);
+
+		std::atomic<bool> valid{ true };
+		utils::Parallel::forEach((numLines + IndexBlockSize - 1) / IndexBlockSize, [&lines, &linesTools, &filesKeys, &filesFirstLine, &valid, indexLines, numLines](size_t block)
+		{
+			auto lineIndex = block * IndexBlockSize;
+			auto lineIndexEnd = std::min(lineIndex + IndexBlockSize, numLines);
+
+			auto fileIndex = static_cast<size_t>(std::upper_bound(filesFirstLine.begin(), filesFirstLine.end(), lineIndex) - filesFirstLine.begin()) - 1;
+
+			for (; lineIndex < lineIndexEnd; lineIndex++)
+			{
+				while (lineIndex >= filesFirstLine[fileIndex + 1])
+					fileIndex++;
+
+				IndexLine indexLine;
+				std::memcpy(&indexLine, indexLines + (lineIndex * sizeof(IndexLine)), sizeof(IndexLine));
+
+				const auto& file = filesKeys[fileIndex];
+				if ((indexLine.dataOffset > file.info.size) || (indexLine.dataSize > (file.info.size - indexLine.dataOffset)))
+				{
+					valid = false;
+					return;
+				}
+
+				auto& line = lines[lineIndex];
+				line.id = static_cast<int32_t>(lineIndex + 1);
+				line.dataStart = file.data + indexLine.dataOffset;
+				line.dataSize = indexLine.dataSize;
+
+				//the sections must be inside the line, like its data is inside the files
+				line.sections = indexLine.sections;
+
+				auto lineSize = static_cast<uint64_t>(line.dataSize);
+				for (auto section : LineSections)
+				{
+					if ((static_cast<uint64_t>(line.sectionOffset(section)) + line.sectionSize(section)) > lineSize)
+					{
+						valid = false;
+						return;
+					}
+				}
+
+				linesTools.setHeader(lineIndex, { indexLine.timestamp, indexLine.threadId, indexLine.level });
+			}
+		});
+
+		if (!valid)
+		{
+			lines.clear();
+			linesTools.resizeHeaders(0);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool LinesCache::store(const FilesRepo& repoFiles, std::string_view cacheFolderPath, const std::vector<LogLine>& lines, const LinesTools& linesTools)
+	{
+		std::vector<FileKey> filesKeys;
+		if (!genFilesKeys(repoFiles, filesKeys))
+			return false;
+
+		//lines are in the same order as the files, so each file is just a range of lines
+		std::vector<size_t> linesFile(lines.size());
+		{
+			size_t fileIndex{ 0 };
+			for (size_t i = 0; i < lines.size(); i++)
+			{
+				const auto& line = lines[i];
+
+				while ((fileIndex < filesKeys.size()) && ((line.dataStart < filesKeys[fileIndex].data) || (line.dataStart >= filesKeys[fileIndex].dataEnd)))
+					fileIndex++;
+
+				if (fileIndex >= filesKeys.size())
+					return false;
+
+				linesFile[i] = fileIndex;
+				filesKeys[fileIndex].info.numLines++;
+			}
+		}
+
+		return writeIndex(std::filesystem::u8path(indexPath(repoFiles, cacheFolderPath)), [&repoFiles, &lines, &linesTools, &filesKeys, &linesFile](std::ostream& out)
+		{
+			writeIndexStart(out, IndexMagic, repoFiles, filesKeys, lines.size());
+
+			std::vector<IndexLine> indexLines;
+			indexLines.reserve(std::min(lines.size(), IndexBlockSize));
+
+			for (size_t i = 0; i < lines.size(); i++)
+			{
+				const auto& line = lines[i];
+				const auto& file = filesKeys[linesFile[i]];
+
+				if (line.dataEnd() > file.dataEnd)
+					return false;
+
+				auto header = linesTools.header(i);
+
+				IndexLine indexLine;
+				std::memset(&indexLine, 0, sizeof(IndexLine));
+				indexLine.timestamp = header.timestamp;
+				indexLine.dataOffset = static_cast<uint64_t>(line.dataStart - file.data);
+				indexLine.dataSize = line.dataSize;
+				indexLine.threadId = header.threadId;
+				indexLine.sections = line.sections;
+				indexLine.level = header.level;
+
+				indexLines.push_back(indexLine);
+				if ((indexLines.size() >= IndexBlockSize) || ((i + 1) == lines.size()))
+				{
+					out.write(reinterpret_cast<const char*>(indexLines.data()), indexLines.size() * sizeof(IndexLine));
+					indexLines.clear();
+				}
+			}
+
+			return true;
+		});
+	}
+
+	std::string LinesCache::searchIndexPath(const FilesRepo& repoFiles, std::string_view cacheFolderPath)
+	{
+		return cacheFilePath(repoFiles, cacheFolderPath, ".la_search_index").u8string();
+	}
+
+	bool LinesCache::loadSearchIndex(const FilesRepo& repoFiles, std::string_view cacheFolderPath, const std::vector<LogLine>& lines, TrigramIndex& searchIndex)
+	{
+		std::vector<FileKey> filesKeys;
+		if (!genFilesKeys(repoFiles, filesKeys))
+			return false;
+
+		MemoryMappedFile index{ searchIndexPath(repoFiles, cacheFolderPath) };
+		if (!index)
+			return false;
+
+		IndexReader reader{ index.dataAs<const char*>(), index.dataAs<const char*>(), index.dataAs<const char*>() + index.size() };
+
+		IndexHeader header;
+		std::vector<IndexFile> files;
+		if (!readIndexStart(reader, SearchIndexMagic, repoFiles, filesKeys, header, files) || (header.numLines != lines.size()))
+			return false;
+
+		if (!searchIndex.load(reader.walker, static_cast<size_t>(reader.walkerEnd - reader.walker)) || (searchIndex.numLines() != lines.size()))
+		{
+			searchIndex = {};
+			return false;
+		}
+
+		return true;
+	}
+
+	bool LinesCache::storeSearchIndex(const FilesRepo& repoFiles, std::string_view cacheFolderPath, const TrigramIndex& searchIndex)
+	{
+		std::vector<FileKey> filesKeys;
+		if (!genFilesKeys(repoFiles, filesKeys))
+			return false;
+
+		return writeIndex(std::filesystem::u8path(searchIndexPath(repoFiles, cacheFolderPath)), [&repoFiles, &searchIndex, &filesKeys](std::ostream& out)
+		{
+			writeIndexStart(out, SearchIndexMagic, repoFiles, filesKeys, searchIndex.numLines());
+			return searchIndex.store(out);
+		});
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef LA_LINES_CACHE_HPP
+#define LA_LINES_CACHE_HPP
+
+#include "log_line.hpp"
+#include "trigram_index.hpp"
+
+#include <string>
+#include <vector>
+#include <string_view>
+
+namespace la
+{
+	class FilesRepo;
+	class LinesTools;
+
+	class LinesCache final
+	{
+	public:
+		//the index is stored next to the files, or in "cacheFolderPath" when it's set (and is only valid for the exact same files, with the same content)
+		static std::string indexPath(const FilesRepo& repoFiles, std::string_view cacheFolderPath);
+
+		//the headers of the lines are in the columns of "linesTools" (which are set on load)
+		static bool load(const FilesRepo& repoFiles, std::string_view cacheFolderPath, std::vector<LogLine>& lines, LinesTools& linesTools);
+		static bool store(const FilesRepo& repoFiles, std::string_view cacheFolderPath, const std::vector<LogLine>& lines, const LinesTools& linesTools);
+
+		//the search index of the lines is stored next to them too (and is only valid for the same lines)
+		static std::string searchIndexPath(const FilesRepo& repoFiles, std::string_view cacheFolderPath);
+
+		static bool loadSearchIndex(const FilesRepo& repoFiles, std::string_view cacheFolderPath, const std::vector<LogLine>& lines, TrigramIndex& searchIndex);
+		static bool storeSearchIndex(const FilesRepo& repoFiles, std::string_view cacheFolderPath, const TrigramIndex& searchIndex);
+	};
+}
+
+#endif
@@ -2,6 +2,9 @@
 
 #include "utils.hpp"
 #include "files_repo.hpp"
+#include "lines_cache.hpp"
+#include "text_searcher.hpp"
+#include "regex_searcher.hpp"
 #include "inspectors_repo.hpp"
 
 #include <set>
@@ -10,6 +13,7 @@
 #include <cassert>
 #include <fstream>
 #include <iomanip>
+#include <numeric>
 #include <algorithm>
 #include <filesystem>
 #include <functional>
@@ -19,36 +23,172 @@
 
 namespace la
 {
+	struct LinesRepo::FindContext::Matcher
+	{
+		std::string query;
+		std::string error; //why the query can't be searched (then there is no searcher)
+
+		std::optional<TextSearcher> textSearcher;
+		std::optional<RegexSearcher> regexSearcher;
+
+		bool isValid() const noexcept
+		{
+			return (textSearcher.has_value() || regexSearcher.has_value());
+		}
+
+		//the first match in the data ("dataEnd" when there is none)
+		const char* operator()(const char* dataStart, const char* dataEnd) const
+		{
+			return textSearcher.has_value() ? textSearcher.value()(dataStart, dataEnd) : regexSearcher.value()(dataStart, dataEnd);
+		}
+
+		//the size of all the matches (0 when it isn't known)
+		size_t matchSize() const noexcept
+		{
+			return textSearcher.has_value() ? textSearcher.value().size() : regexSearcher.value().fixedSize();
+		}
+
+		//the text all the matches have (for the search index)
+		std::string_view requiredText() const noexcept
+		{
+			return textSearcher.has_value() ? std::string_view{ query } : regexSearcher.value().literal();
+		}
+	};
+
+	namespace
+	{
+		constexpr size_t ParseChunkSize{ 32 * 1024 * 1024 }; //big files are split and parsed in parallel, in chunks of this size
+
+		//the text or regex is compiled once, and then used by all the searches of the query (an invalid regex has no matches)
+		std::shared_ptr<const LinesRepo::FindContext::Matcher> makeFindMatcher(std::string_view query, LinesRepo::FindOptions::CaseSensitivity caseSensitivity, bool isRegex)
+		{
+			auto matcher = std::make_shared<LinesRepo::FindContext::Matcher>();
+			matcher->query = query;
+
+			auto ignoreCase = (caseSensitivity != LinesRepo::FindOptions::CaseSensitivity::CaseSensitive);
+			if (!isRegex)
+			{
+				matcher->textSearcher.emplace(query, ignoreCase);
+				return matcher;
+			}
+
+			try
+			{
+				if (ignoreCase)
+					matcher->regexSearcher.emplace(query, std::regex::ECMAScript | std::regex::optimize | std::regex::icase);
+				else
+					matcher->regexSearcher.emplace(query, std::regex::ECMAScript | std::regex::optimize);
+			}
+			catch (const std::regex_error& exp)
+			{
+				matcher->error = exp.what();
+			}
+
+			return matcher;
+		}
+
+		//a start given by the caller is kept inside the lines (past the end of its line, it is moved to the last byte of the line)
+		void clampFindStart(const std::vector<LogLine>& lines, LinesRepo::FindOptions& options)
+		{
+			if ((options.startLine == 0) && (options.startLineOffset == 0))
+				return;
+
+			if (options.startLine >= lines.size())
+				options.startLine = lines.size() - 1;
+
+			auto& line = lines[options.startLine];
+			if (options.startLineOffset >= line.dataSize)
+				options.startLineOffset = (line.dataSize == 0) ? 0 : (line.dataSize - 1);
+		}
+
+		//the matches of a find all, given in order and grouped by line: [{ "index": lineIndex, "offsets": [lineOffset, ...] }, ...]
+		class FindAllWriter
+		{
+		public:
+			void add(size_t lineIndex, size_t lineOffset)
+			{
+				if (!m_lineOffsets.empty() && (lineIndex != m_lineIndex))
+					flushLine();
+
+				m_lineIndex = lineIndex;
+				m_lineOffsets.push_back(lineOffset);
+			}
+
+			std::string dump()
+			{
+				flushLine();
+				return m_jLines.dump();
+			}
+
+		private:
+			void flushLine()
+			{
+				if (m_lineOffsets.empty())
+					return;
+
+				nlohmann::json jLine;
+				jLine["index"] = m_lineIndex;
+				jLine["offsets"] = std::move(m_lineOffsets);
+				m_jLines.push_back(std::move(jLine));
+
+				m_lineOffsets.clear();
+			}
+
+		private:
+			nlohmann::json m_jLines = nlohmann::json::array();
+			size_t m_lineIndex{ 0 };
+			std::vector<size_t> m_lineOffsets;
+		};
+
+		//the matches go to the writer as they are found, in order (unless the size of the matches is known, the lines are searched one by one)
+		void findAllMatches(const LinesTools& linesTools, size_t numLines, const LinesRepo::FindContext::Matcher& matcher, FindAllWriter& writer)
+		{
+			if (!matcher.isValid())
+				return;
+
+			linesTools.windowSearchAllParallel({ 0, numLines }, matcher.matchSize(), [&matcher](const char* dataStart, const char* dataEnd)
+			{
+				return matcher(dataStart, dataEnd);
+			}, [&writer](size_t lineIndex, size_t lineOffset) { writer.add(lineIndex, lineOffset); }, matcher.requiredText());
+		}
+	}
+
 	std::vector<std::string> LinesRepo::listFolderFiles(FlavorsRepo::Type type, std::string_view folderPath)
 	{
 		return FilesRepo::listFolderFiles(type, folderPath);
 	}
 
 	std::unique_ptr<LinesRepo> LinesRepo::initRepoFile(FlavorsRepo::Type type, std::string_view filePath)
+	{
+		return LinesRepo::initRepoFile(type, filePath, {});
+	}
+
+	std::unique_ptr<LinesRepo> LinesRepo::initRepoFile(FlavorsRepo::Type type, std::string_view filePath, CacheOptions cacheOptions)
 	{
 		auto repoFiles = FilesRepo::initRepoFile(type, filePath);
 		if (!repoFiles)
 			return nullptr;
 
-		return std::unique_ptr<LinesRepo>{ new LinesRepo(std::move(repoFiles)) };
+		return std::unique_ptr<LinesRepo>{ new LinesRepo(std::move(repoFiles), cacheOptions) };
 	}
 
 	std::unique_ptr<LinesRepo> LinesRepo::initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath)
 	{
-		auto repoFiles = FilesRepo::initRepoFolder(type, folderPath);
-		if (!repoFiles)
-			return nullptr;
-
-		return std::unique_ptr<LinesRepo>{ new LinesRepo(std::move(repoFiles)) };
+		return LinesRepo::initRepoFolder(type, folderPath, {}, {});
 	}
 
 	std::unique_ptr<LinesRepo> LinesRepo::initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath, std::string_view fileNameFilterRegex)
+	{
+		return LinesRepo::initRepoFolder(type, folderPath, fileNameFilterRegex, {});
+	}
+
+	std::unique_ptr<LinesRepo> LinesRepo::initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath, std::string_view fileNameFilterRegex, CacheOptions cacheOptions)
 	{
 		auto repoFiles = FilesRepo::initRepoFolder(type, folderPath, fileNameFilterRegex);
 		if (!repoFiles)
 			return nullptr;
 
-		return std::unique_ptr<LinesRepo>{ new LinesRepo(std::move(repoFiles)) };
+		return std::unique_ptr<LinesRepo>{ new LinesRepo(std::move(repoFiles), cacheOptions) };
 	}
 
 	std::unique_ptr<LinesRepo> LinesRepo::initRepoFromCommnand(const LinesRepo& sourceRepo, std::string_view commandResult)
@@ -56,7 +196,7 @@ namespace la
 		if (commandResult.empty())
 			return nullptr;
 
-		std::vector<LogLine> logLines;
+		std::vector<size_t> linesIndices;
 		{
 			auto jRoot = nlohmann::json::parse(commandResult);
 			if (!jRoot.is_object() || !jRoot.contains("linesIndices") || !jRoot["linesIndices"].is_array())
@@ -77,15 +217,15 @@ namespace la
 					if ((value < 0) || (value >= sourceRepo.m_lines.size()))
 						continue;
 
-					logLines.push_back(sourceRepo.m_lines[value]);
+					linesIndices.push_back(value);
 				}
 			}
 		}
 
-		if (logLines.empty())
+		if (linesIndices.empty())
 			return nullptr;
 
-		return std::unique_ptr<LinesRepo>{ new LinesRepo(sourceRepo, std::move(logLines)) };
+		return std::unique_ptr<LinesRepo>{ new LinesRepo(sourceRepo, linesIndices) };
 	}
 
 	std::unique_ptr<LinesRepo> LinesRepo::initRepoFromLineRange(const LinesRepo& sourceRepo, size_t indexStart, size_t count)
@@ -93,13 +233,10 @@ namespace la
 		if ((count <= 0) || ((indexStart + count) > sourceRepo.m_lines.size()))
 			return nullptr;
 
-		std::vector<LogLine> logLines;
-		logLines.reserve(count);
+		std::vector<size_t> linesIndices(count);
+		std::iota(linesIndices.begin(), linesIndices.end(), indexStart);
 
-		for (; count > 0; count--)
-			logLines.push_back(sourceRepo.m_lines[indexStart++]);
-
-		return std::unique_ptr<LinesRepo>{ new LinesRepo(sourceRepo, std::move(logLines)) };
+		return std::unique_ptr<LinesRepo>{ new LinesRepo(sourceRepo, linesIndices) };
 	}
 
 	std::unique_ptr<LinesRepo> LinesRepo::initRepoFromTags(const LinesRepo& sourceRepo, const std::vector<std::string_view>& tags)
@@ -121,9 +258,10 @@ namespace la
 
 		std::tuple<std::string_view, bool> lastResult;
 
-		std::vector<LogLine> logLines;
-		for (const auto& line : sourceRepo.m_lines)
+		std::vector<size_t> linesIndices;
+		for (size_t lineIndex = 0; lineIndex < sourceRepo.m_lines.size(); lineIndex++)
 		{
+			const auto& line = sourceRepo.m_lines[lineIndex];
 			auto curTag = line.getSectionTag();
 
 			bool match = false;
@@ -141,10 +279,10 @@ namespace la
 			}
 
 			if (match)
-				logLines.push_back(line);
+				linesIndices.push_back(lineIndex);
 		}
 
-		return std::unique_ptr<LinesRepo>{ new LinesRepo(sourceRepo, std::move(logLines)) };
+		return std::unique_ptr<LinesRepo>{ new LinesRepo(sourceRepo, linesIndices) };
 	}
 
 	size_t LinesRepo::numFiles() const noexcept
@@ -162,95 +300,108 @@ namespace la
 		return m_repoFiles->flavor();
 	}
 
-	LinesRepo::FindContext LinesRepo::searchText(std::string_view query, FindOptions options) const
+	bool LinesRepo::loadedFromCache() const noexcept
 	{
-		if (m_lines.empty() || query.empty())
-			return LinesRepo::FindContext{ {}, options.caseSensitivity, false };
+		return m_loadedFromCache;
+	}
 
-		if ((options.startLine > 0) || (options.startLineOffset > 0))
-		{
-			if (options.startLine >= m_lines.size())
-				options.startLine = m_lines.size() - 1;
+	LinesRepo::~LinesRepo()
+	{
+		stopSearchIndex();
+	}
 
-			auto& line = m_lines[options.startLine];
-			if (options.startLineOffset >= line.data.size())
-				options.startLineOffset = line.data.empty() ? 0 : (line.data.size() - 1);
+	std::optional<size_t> LinesRepo::refresh()
+	{
+		if (!m_ownsFiles)
+			return std::nullopt;
+
+		//the lines (and the files) can't change while they are being indexed, the search index is extended with the new ones after
+		stopSearchIndex();
+
+		std::vector<FilesRepo::FileChange> changes;
+		if (!m_repoFiles->refresh(changes))
+		{
+			buildSearchIndex(false);
+			return std::nullopt;
 		}
 
-		LinesTools::SearchResult result;
+		auto numLines = m_lines.size();
 
-		if (options.caseSensitivity == FindOptions::CaseSensitivity::CaseSensitive)
+		std::vector<std::string_view> filesData;
+		for (const auto& change : changes)
 		{
-			std::boyer_moore_searcher bmSearcher{ query.begin(), query.end() };
+			auto data = reinterpret_cast<const char*>(change.data);
 
-			result = m_linesTools.windowSearch({ options.startLine, m_lines.size() }, options.startLineOffset, [&bmSearcher](const char* dataStart, const char* dataEnd)
+			if (!change.previousData)
 			{
-				return std::search(dataStart, dataEnd, bmSearcher);
-			});
-		}
-		else
-		{
-			auto bmHash = std::hash<typename std::iterator_traits<std::string_view::iterator>::value_type>();
-			std::boyer_moore_searcher bmSearcher{ query.begin(), query.end(), bmHash, [](const std::iterator_traits<std::string_view::iterator>::value_type& lhs, const std::iterator_traits<std::string_view::iterator>::value_type& rhs)
+				filesData.emplace_back(data, change.size);
+				continue;
+			}
+
+			//the lines of a file that grew are the last ones: they are moved to the new mapping...
+			auto previousData = reinterpret_cast<const char*>(change.previousData);
+			auto previousDataEnd = previousData + change.previousSize;
+
+			auto fileFirstLine = m_lines.size();
+			while ((fileFirstLine > 0) && (m_lines[fileFirstLine - 1].dataStart >= previousData) && (m_lines[fileFirstLine - 1].dataStart < previousDataEnd))
+				fileFirstLine--;
+
+			for (auto i = fileFirstLine; i < m_lines.size(); i++)
+				m_lines[i].dataStart = data + (m_lines[i].dataStart - previousData); //the lines are inside their file, their size doesn't change
+
+			//... and the last one is parsed again, with the new content (it may have been incomplete or have more multiline content now)
+			if (fileFirstLine < m_lines.size())
 			{
-				return (std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs)));
-			} };
+				auto lastLineStart = m_lines.back().dataStart;
+				m_lines.pop_back();
 
-			result = m_linesTools.windowSearch({ options.startLine, m_lines.size() }, options.startLineOffset, [&bmSearcher](const char* dataStart, const char* dataEnd)
+				filesData.emplace_back(lastLineStart, static_cast<size_t>(data + change.size - lastLineStart));
+			}
+			else
 			{
-				return std::search(dataStart, dataEnd, bmSearcher);
-			});
+				filesData.emplace_back(data, change.size);
+			}
 		}
 
-		if (!result.valid)
-			return LinesRepo::FindContext{ std::string{ query}, options.caseSensitivity, false };
+		auto firstChangedLine = m_lines.size();
+		appendFilesData(filesData);
+
+		m_linesTools.updateColumns(firstChangedLine);
+
+		//the lines from the first changed one on are indexed again
+		m_linesTools.setSearchIndex(nullptr);
+		m_searchIndex->truncate(firstChangedLine);
+		buildSearchIndex(false);
 
-		return LinesRepo::FindContext{ std::string{ query}, options.caseSensitivity, false, m_lines[result.lineIndex], result.lineIndex, result.lineOffset };
+		return (m_lines.size() > numLines) ? (m_lines.size() - numLines) : 0;
 	}
 
-	LinesRepo::FindContext LinesRepo::searchTextRegex(std::string_view query, FindOptions options) const
+	std::string_view LinesRepo::FindContext::query() const noexcept
 	{
-		if (m_lines.empty() || query.empty())
-			return LinesRepo::FindContext{ {}, options.caseSensitivity, true };
-
-		if ((options.startLine > 0) || (options.startLineOffset > 0))
-		{
-			if (options.startLine >= m_lines.size())
-				options.startLine = m_lines.size() - 1;
+		return m_matcher ? std::string_view{ m_matcher->query } : std::string_view{};
+	}
 
-			auto& line = m_lines[options.startLine];
-			if (options.startLineOffset >= line.data.size())
-				options.startLineOffset = line.data.empty() ? 0 : (line.data.size() - 1);
-		}
+	std::string_view LinesRepo::FindContext::queryError() const noexcept
+	{
+		return m_matcher ? std::string_view{ m_matcher->error } : std::string_view{};
+	}
 
-		std::regex regQuery;
-		try
-		{
-			switch (options.caseSensitivity)
-			{
-			case FindOptions::CaseSensitivity::CaseSensitive:
-				regQuery = std::regex{ std::string{ query }, std::regex::ECMAScript | std::regex::optimize };
-				break;
-			default:
-				regQuery = std::regex{ std::string{ query }, std::regex::ECMAScript | std::regex::optimize | std::regex::icase };
-				break;
-			}
-		}
-		catch (std::regex_error exp)
-		{ }
+	LinesRepo::FindContext LinesRepo::searchText(std::string_view query, FindOptions options) const
+	{
+		if (m_lines.empty() || query.empty())
+			return {};
 
-		auto result = m_linesTools.windowSearch({ options.startLine, m_lines.size() }, options.startLineOffset, [&regQuery](const char* dataStart, const char* dataEnd)
-		{
-			std::cmatch matches;
-			if (!std::regex_search(dataStart, dataEnd, matches, regQuery))
-				return dataEnd;
+		clampFindStart(m_lines, options);
+		return searchFrom(makeFindMatcher(query, options.caseSensitivity, false), options.startLine, options.startLineOffset);
+	}
 
-			return matches[0].first;
-		});
-		if (!result.valid)
-			return LinesRepo::FindContext{ std::string{ query}, options.caseSensitivity, true };
+	LinesRepo::FindContext LinesRepo::searchTextRegex(std::string_view query, FindOptions options) const
+	{
+		if (m_lines.empty() || query.empty())
+			return {};
 
-		return LinesRepo::FindContext{ std::string{ query}, options.caseSensitivity, true, m_lines[result.lineIndex], result.lineIndex, result.lineOffset };
+		clampFindStart(m_lines, options);
+		return searchFrom(makeFindMatcher(query, options.caseSensitivity, true), options.startLine, options.startLineOffset);
 	}
 
 	LinesRepo::FindContext LinesRepo::searchNext(FindContext ctx) const
@@ -258,113 +409,60 @@ namespace la
 		if (!ctx.m_result.valid)
 			return ctx;
 
-		if (ctx.m_isRegex)
-		{
-			std::regex regQuery;
-			try
-			{
-				switch (ctx.m_caseSensitivity)
-				{
-				case FindOptions::CaseSensitivity::CaseSensitive:
-					regQuery = std::regex{ ctx.m_query, std::regex::ECMAScript | std::regex::optimize };
-					break;
-				default:
-					regQuery = std::regex{ ctx.m_query, std::regex::ECMAScript | std::regex::optimize | std::regex::icase };
-					break;
-				}
-			}
-			catch (std::regex_error exp)
-			{ }
-
-			auto result = m_linesTools.windowSearch({ ctx.m_result.lineIndex, m_lines.size() }, ctx.m_result.lineOffset + 1, [&regQuery](const char* dataStart, const char* dataEnd)
-			{
-				std::cmatch matches;
-				if (!std::regex_search(dataStart, dataEnd, matches, regQuery))
-					return dataEnd;
-
-				return matches[0].first;
-			});
-			if (!result.valid)
-				return LinesRepo::FindContext{ ctx.m_query, ctx.m_caseSensitivity, true };
+		//the matcher of the context is used as is, only the lines after the current result are searched
+		auto startLine = ctx.m_result.lineIndex;
+		auto startLineOffset = ctx.m_result.lineOffset + 1;
 
-			return LinesRepo::FindContext{ ctx.m_query, ctx.m_caseSensitivity, true, m_lines[result.lineIndex], result.lineIndex, result.lineOffset };
-		}
-		else
+		//a match at the end of its line continues on the next line (the start isn't clamped, that would find the same match again)
+		if ((startLine < m_lines.size()) && (startLineOffset >= m_lines[startLine].dataSize))
 		{
-			LinesTools::SearchResult result;
+			startLine++;
+			startLineOffset = 0;
+		}
 
-			if (ctx.m_caseSensitivity == FindOptions::CaseSensitivity::CaseSensitive)
-			{
-				std::boyer_moore_searcher bmSearcher(ctx.m_query.begin(), ctx.m_query.end());
+		if (startLine >= m_lines.size())
+			return FindContext{ std::move(ctx.m_matcher) };
 
-				result = m_linesTools.windowSearch({ ctx.m_result.lineIndex, m_lines.size() }, ctx.m_result.lineOffset + 1, [&bmSearcher](const char* dataStart, const char* dataEnd) { return std::search(dataStart, dataEnd, bmSearcher); });
-			}
-			else
-			{
-				auto bmHash = std::hash<typename std::iterator_traits<std::string::iterator>::value_type>();
-				std::boyer_moore_searcher bmSearcher{ ctx.m_query.begin(), ctx.m_query.end(), bmHash, [](const std::iterator_traits<std::string::iterator>::value_type& lhs, const std::iterator_traits<std::string::iterator>::value_type& rhs)
-				{
-					return (std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs)));
-				} };
+		return searchFrom(std::move(ctx.m_matcher), startLine, startLineOffset);
+	}
 
-				result = m_linesTools.windowSearch({ ctx.m_result.lineIndex, m_lines.size() }, ctx.m_result.lineOffset + 1, [&bmSearcher](const char* dataStart, const char* dataEnd) { return std::search(dataStart, dataEnd, bmSearcher); });
-			}
+	LinesRepo::FindContext LinesRepo::searchFrom(std::shared_ptr<const FindContext::Matcher> matcher, size_t startLine, size_t startLineOffset) const
+	{
+		if (m_lines.empty() || !matcher->isValid())
+			return FindContext{ std::move(matcher) };
 
-			if (!result.valid)
-				return LinesRepo::FindContext{ ctx.m_query, ctx.m_caseSensitivity, false };
+		const auto& matcherRef = *matcher;
+		auto result = m_linesTools.windowSearchParallel({ startLine, m_lines.size() }, startLineOffset, [&matcherRef](const char* dataStart, const char* dataEnd)
+		{
+			return matcherRef(dataStart, dataEnd);
+		}, matcherRef.requiredText());
 
-			return LinesRepo::FindContext{ ctx.m_query, ctx.m_caseSensitivity, false, m_lines[result.lineIndex], result.lineIndex, result.lineOffset };
-		}
+		if (!result.valid)
+			return FindContext{ std::move(matcher) };
+
+		return FindContext{ std::move(matcher), m_lines[result.lineIndex], result.lineIndex, result.lineOffset };
 	}
 
 	std::string LinesRepo::findAll(std::string_view query, FindOptions::CaseSensitivity caseSensitivity) const
 	{
-		std::unordered_map<size_t, std::vector<size_t>> curLineMatches;
-		{
-			auto ctx = searchText(query, FindOptions{ caseSensitivity });
-			while (ctx.isValid())
-			{
-				curLineMatches[std::get<0>(ctx.position())].push_back(std::get<1>(ctx.position()));
-				ctx = searchNext(ctx);
-			}
-		}
+		FindAllWriter writer;
 
-		auto jLines = nlohmann::json::array();
-
-		for (auto& [lineIndex, lineOffsets] : curLineMatches)
-		{
-			nlohmann::json jLine;
-			jLine["index"] = lineIndex;
-			jLine["offsets"] = std::move(lineOffsets);
-			jLines.push_back(std::move(jLine));
-		}
+		if (m_lines.empty() || query.empty())
+			return writer.dump();
 
-		return jLines.dump();
+		findAllMatches(m_linesTools, m_lines.size(), *makeFindMatcher(query, caseSensitivity, false), writer);
+		return writer.dump();
 	}
 
 	std::string LinesRepo::findAllRegex(std::string_view query, FindOptions::CaseSensitivity caseSensitivity) const
 	{
-		std::unordered_map<size_t, std::vector<size_t>> curLineMatches;
-		{
-			auto ctx = searchTextRegex(query, FindOptions{ caseSensitivity });
-			while (ctx.isValid())
-			{
-				curLineMatches[std::get<0>(ctx.position())].push_back(std::get<1>(ctx.position()));
-				ctx = searchNext(ctx);
-			}
-		}
+		FindAllWriter writer;
 
-		auto jLines = nlohmann::json::array();
-
-		for (auto& [lineIndex, lineOffsets] : curLineMatches)
-		{
-			nlohmann::json jLine;
-			jLine["index"] = lineIndex;
-			jLine["offsets"] = std::move(lineOffsets);
-			jLines.push_back(std::move(jLine));
-		}
+		if (m_lines.empty() || query.empty())
+			return writer.dump();
 
-		return jLines.dump();
+		findAllMatches(m_linesTools, m_lines.size(), *makeFindMatcher(query, caseSensitivity, true), writer);
+		return writer.dump();
 	}
 
 	std::string LinesRepo::retrieveLineContent(size_t lineIndex, TranslatorsRepo::Type type, TranslatorsRepo::Format format) const
@@ -375,7 +473,7 @@ namespace la
 		const auto& line = m_lines[lineIndex];
 
 		TranslatorsRepo::TranslationCtx translationCtx;
-		return (TranslatorsRepo::translate(type, format, flavor(), line, translationCtx) ? translationCtx.output : "");
+		return (TranslatorsRepo::translate(type, format, flavor(), line, m_linesTools.header(lineIndex), translationCtx) ? translationCtx.output : "");
 	}
 
 	std::optional<size_t> LinesRepo::getLineIndex(int32_t lineId) const noexcept
@@ -397,7 +495,7 @@ namespace la
 	{
 		auto jSummary = nlohmann::json::object();
 
-		jSummary["timeRange"] = { m_lines.front().timestamp, m_lines.back().timestamp };
+		jSummary["timeRange"] = { m_linesTools.timestamps().front(), m_linesTools.timestamps().back() };
 		jSummary["numLines"] = m_lines.size();
 
 		{
@@ -432,24 +530,38 @@ namespace la
 
 		{
 			std::set<int32_t> uniqueThreads;
-			for (const auto& line : m_lines)
-				uniqueThreads.insert(line.threadId);
+			for (auto threadId : m_linesTools.threadIds())
+				uniqueThreads.insert(threadId);
 
 			jSummary["threadIds"] = uniqueThreads;
 		}
 
 		{
+			std::vector<size_t> threadNamesCount(m_linesTools.threadNames().size(), 0);
+			for (auto threadNameId : m_linesTools.threadNameIds())
+				threadNamesCount[threadNameId]++;
+
 			std::set<std::string_view> uniqueThreads;
-			for (const auto& line : m_lines)
-				uniqueThreads.insert(line.getSectionThreadName());
+			for (uint32_t id = 0; id < threadNamesCount.size(); id++)
+			{
+				if (threadNamesCount[id] > 0)
+					uniqueThreads.insert(m_linesTools.threadNames().value(id));
+			}
 
 			jSummary["threadNames"] = uniqueThreads;
 		}
 
 		{
+			std::vector<size_t> tagsCount(m_linesTools.tags().size(), 0);
+			for (auto tagId : m_linesTools.tagIds())
+				tagsCount[tagId]++;
+
 			std::map<std::string_view, size_t> uniqueTags;
-			for (const auto& line : m_lines)
-				uniqueTags[line.getSectionTag()]++;
+			for (uint32_t id = 0; id < tagsCount.size(); id++)
+			{
+				if (tagsCount[id] > 0)
+					uniqueTags[m_linesTools.tags().value(id)] = tagsCount[id];
+			}
 
 			struct Node {
 				std::string_view name;
@@ -792,7 +904,7 @@ namespace la
 			{
 				const auto& line = m_lines[indexStart];
 
-				out.write(line.data.start, static_cast<size_t>(line.data.end - line.data.start));
+				out.write(line.dataStart, line.dataSize);
 				out.put('\n');
 			}
 
@@ -812,10 +924,10 @@ namespace la
 			translationCtx.output.clear();
 			translationCtx.auxiliary.clear();
 
-			if (TranslatorsRepo::translate(options.translationType, options.translationFormat, repoFlavor, line, translationCtx))
+			if (TranslatorsRepo::translate(options.translationType, options.translationFormat, repoFlavor, line, m_linesTools.header(indexStart), translationCtx))
 				out.write(translationCtx.output.data(), translationCtx.output.size());
 			else
-				out.write(line.data.start, static_cast<size_t>(line.data.end - line.data.start));
+				out.write(line.dataStart, line.dataSize);
 
 			out.write("\n", 1);
 		}
@@ -861,7 +973,7 @@ namespace la
 						continue;
 
 					const auto& line = m_lines[value];
-					out.write(line.data.start, static_cast<size_t>(line.data.end - line.data.start));
+					out.write(line.dataStart, line.dataSize);
 					out.write("\n", 1);
 				}
 			}
@@ -883,10 +995,10 @@ namespace la
 					translationCtx.output.clear();
 					translationCtx.auxiliary.clear();
 
-					if (TranslatorsRepo::translate(options.translationType, options.translationFormat, repoFlavor, line, translationCtx))
+					if (TranslatorsRepo::translate(options.translationType, options.translationFormat, repoFlavor, line, m_linesTools.header(value), translationCtx))
 						out.write(translationCtx.output.data(), translationCtx.output.size());
 					else
-						out.write(line.data.start, static_cast<size_t>(line.data.end - line.data.start));
+						out.write(line.dataStart, line.dataSize);
 
 					out.write("\n", 1);
 				}
@@ -966,18 +1078,39 @@ namespace la
 		return true;
 	}
 
-	LinesRepo::LinesRepo(std::shared_ptr<FilesRepo> repoFiles)
+	LinesRepo::LinesRepo(std::shared_ptr<FilesRepo> repoFiles, CacheOptions cacheOptions)
 		: m_linesTools{ m_lines }
 		, m_repoFiles{ std::move(repoFiles) }
+		, m_ownsFiles{ true }
+		, m_cacheEnabled{ cacheOptions.enabled }
+		, m_cacheFolderPath{ cacheOptions.folderPath }
 	{
-		m_repoFiles->iterateFiles([this](const void* data, size_t size)
+		//files that were already parsed before have their lines in an index...
+		m_loadedFromCache = m_cacheEnabled && LinesCache::load(*m_repoFiles, m_cacheFolderPath, m_lines, m_linesTools);
+
+		//... otherwise they are parsed (and the index is stored for the next time)
+		if (!m_loadedFromCache)
 		{
-			FlavorsRepo::processFileData(m_repoFiles->flavor(), data, size, m_lines);
-		});
+			std::vector<std::string_view> filesData;
+			m_repoFiles->iterateFiles([&filesData](const void* data, size_t size)
+			{
+				filesData.emplace_back(reinterpret_cast<const char*>(data), size);
+			});
+
+			appendFilesData(filesData);
+
+			if (m_cacheEnabled)
+				LinesCache::store(*m_repoFiles, m_cacheFolderPath, m_lines, m_linesTools);
+		}
 
-		int32_t idGen{ 1 };
-		for (auto& line : m_lines)
-			line.id = idGen++;
+		m_linesTools.updateColumns(0);
+
+		//the search index is stored next to the lines too, otherwise it's built in the background (and stored once done)
+		m_searchIndex = std::make_shared<TrigramIndex>();
+		if (m_cacheEnabled && LinesCache::loadSearchIndex(*m_repoFiles, m_cacheFolderPath, m_lines, *m_searchIndex))
+			m_linesTools.setSearchIndex(m_searchIndex);
+		else
+			buildSearchIndex(m_cacheEnabled);
 
 		CommandsRepo::iterateCommands(m_repoFiles->flavor(), [this](std::string_view tag, CommandsRepo::CommandInfo cmd)
 		{
@@ -990,10 +1123,105 @@ namespace la
 		});
 	}
 
-	LinesRepo::LinesRepo(const LinesRepo& sourceRepo, std::vector<LogLine> logLines)
+	LinesRepo::LinesRepo(const LinesRepo& sourceRepo, const std::vector<size_t>& sourceLinesIndices)
 		: m_linesTools{ m_lines }
-		, m_lines{ std::move(logLines) }
 		, m_cmds{ sourceRepo.m_cmds } //can reuse all the same commands
 		, m_repoFiles{ sourceRepo.m_repoFiles } //store a reference to the files
-	{ }
+	{
+		m_lines.reserve(sourceLinesIndices.size());
+		m_linesTools.resizeHeaders(sourceLinesIndices.size());
+
+		for (auto sourceLineIndex : sourceLinesIndices)
+		{
+			m_linesTools.setHeader(m_lines.size(), sourceRepo.m_linesTools.header(sourceLineIndex));
+			m_lines.push_back(sourceRepo.m_lines[sourceLineIndex]);
+		}
+
+		m_linesTools.updateColumns(0);
+	}
+
+	void LinesRepo::appendFilesData(const std::vector<std::string_view>& filesData)
+	{
+		//each file is split into chunks (at line boundaries) and each chunk is parsed on its own worker...
+		std::vector<std::string_view> chunks;
+		std::vector<bool> chunksFileStart;
+		for (const auto& fileData : filesData)
+		{
+			auto fileChunks = FlavorsRepo::splitFileData(fileData.data(), fileData.size(), ParseChunkSize);
+			for (size_t i = 0; i < fileChunks.size(); i++)
+				chunksFileStart.push_back(i == 0);
+
+			chunks.insert(chunks.end(), fileChunks.begin(), fileChunks.end());
+		}
+
+		std::vector<std::vector<LogLine>> chunksLines(chunks.size());
+		std::vector<std::vector<LogLineHeader>> chunksHeaders(chunks.size());
+		std::vector<const char*> chunksLeadingContentEnd(chunks.size(), nullptr);
+
+		utils::Parallel::forEach(chunks.size(), [this, &chunks, &chunksLines, &chunksHeaders, &chunksLeadingContentEnd](size_t index)
+		{
+			FlavorsRepo::processFileData(m_repoFiles->flavor(), chunks[index].data(), chunks[index].size(), chunksLines[index], chunksHeaders[index], &chunksLeadingContentEnd[index]);
+		});
+
+		//... and then merged in order (the leading content of a chunk belongs to the last line of the previous one, like in a serial parse)
+		//the leading content of a file is dropped instead, like the one of the first file: a line can't continue in another mapping
+		auto firstNewLine = m_lines.size();
+		{
+			size_t numLines{ firstNewLine };
+			for (const auto& chunkLines : chunksLines)
+				numLines += chunkLines.size();
+
+			m_lines.reserve(numLines);
+			m_linesTools.resizeHeaders(numLines);
+		}
+
+		auto fileFirstLine = m_lines.size();
+		for (size_t i = 0; i < chunksLines.size(); i++)
+		{
+			if (chunksFileStart[i])
+				fileFirstLine = m_lines.size();
+
+			if (chunksLeadingContentEnd[i] && (m_lines.size() > fileFirstLine))
+				FlavorsRepo::appendMultilineContent(m_lines.back(), chunksLeadingContentEnd[i]);
+
+			for (size_t j = 0; j < chunksHeaders[i].size(); j++)
+				m_linesTools.setHeader(m_lines.size() + j, chunksHeaders[i][j]);
+
+			m_lines.insert(m_lines.end(), chunksLines[i].begin(), chunksLines[i].end());
+			chunksLines[i] = {};
+			chunksHeaders[i] = {};
+		}
+
+		//ids continue from the existing lines
+		int32_t idGen{ (firstNewLine > 0) ? (m_lines[firstNewLine - 1].id + 1) : 1 };
+		for (auto i = firstNewLine; i < m_lines.size(); i++)
+			m_lines[i].id = idGen++;
+	}
+
+	void LinesRepo::buildSearchIndex(bool storeIndex)
+	{
+		//the index changes while it's built, so the searches don't use it until it's done
+		m_linesTools.setSearchIndex(nullptr);
+
+		m_searchIndexCancel = false;
+		m_searchIndexBuilder = std::thread{ [this, storeIndex]()
+		{
+			if (!m_searchIndex->extend(m_lines, m_searchIndexCancel))
+				return;
+
+			m_linesTools.setSearchIndex(m_searchIndex);
+
+			if (storeIndex)
+				LinesCache::storeSearchIndex(*m_repoFiles, m_cacheFolderPath, *m_searchIndex);
+		} };
+	}
+
+	void LinesRepo::stopSearchIndex()
+	{
+		if (!m_searchIndexBuilder.joinable())
+			return;
+
+		m_searchIndexCancel = true;
+		m_searchIndexBuilder.join();
+	}
 }
@@ -7,6 +7,9 @@
 #include "commands_repo.hpp"
 #include "translators_repo.hpp"
 
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -28,6 +31,12 @@ namespace la
 			TranslatorsRepo::Format translationFormat{ TranslatorsRepo::Format::Line };
 		};
 
+		struct CacheOptions
+		{
+			bool enabled{ true }; //the lines and the search index are loaded from the indexes stored before, and stored once parsed
+			std::string_view folderPath; //where the indexes are stored (next to the files when empty)
+		};
+
 		struct FindOptions
 		{
 			enum class CaseSensitivity { None, CaseSensitive };
@@ -46,6 +55,8 @@ namespace la
 			friend class LinesRepo;
 
 		public:
+			struct Matcher; //the compiled query (only known by the repo)
+
 			FindContext() = default;
 			~FindContext() = default;
 
@@ -54,10 +65,10 @@ namespace la
 				return m_result.valid;
 			}
 
-			std::string_view query() const noexcept
-			{
-				return m_query;
-			}
+			std::string_view query() const noexcept;
+
+			//why the query can't be searched (e.g. an invalid regex), empty when it can
+			std::string_view queryError() const noexcept;
 
 			std::tuple<size_t, size_t> position() const noexcept
 			{
@@ -68,14 +79,12 @@ namespace la
 			}
 
 		private:
-			FindContext(std::string query, FindOptions::CaseSensitivity caseSensitivity, bool isRegex)
-				: m_isRegex{ isRegex }
-				, m_query{ std::move(query) }
-				, m_caseSensitivity{ caseSensitivity }
+			FindContext(std::shared_ptr<const Matcher> matcher)
+				: m_matcher{ std::move(matcher) }
 			{ }
 
-			FindContext(std::string query, FindOptions::CaseSensitivity caseSensitivity, bool isRegex, LogLine line, size_t lineIndex, size_t lineOffset)
-				: FindContext{ std::move(query), caseSensitivity, isRegex }
+			FindContext(std::shared_ptr<const Matcher> matcher, LogLine line, size_t lineIndex, size_t lineOffset)
+				: FindContext{ std::move(matcher) }
 			{
 				m_result.valid = true;
 				m_result.line = line;
@@ -84,9 +93,7 @@ namespace la
 			}
 
 		private:
-			bool m_isRegex{ false };
-			std::string m_query;
-			FindOptions::CaseSensitivity m_caseSensitivity;
+			std::shared_ptr<const Matcher> m_matcher; //the compiled query, shared with the contexts of the next results
 
 			struct {
 				bool valid{ false };
@@ -100,15 +107,17 @@ namespace la
 		static std::vector<std::string> listFolderFiles(FlavorsRepo::Type type, std::string_view folderPath);
 
 		static std::unique_ptr<LinesRepo> initRepoFile(FlavorsRepo::Type type, std::string_view filePath);
+		static std::unique_ptr<LinesRepo> initRepoFile(FlavorsRepo::Type type, std::string_view filePath, CacheOptions cacheOptions);
 		static std::unique_ptr<LinesRepo> initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath);
 		static std::unique_ptr<LinesRepo> initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath, std::string_view fileNameFilterRegex);
+		static std::unique_ptr<LinesRepo> initRepoFolder(FlavorsRepo::Type type, std::string_view folderPath, std::string_view fileNameFilterRegex, CacheOptions cacheOptions);
 
 		static std::unique_ptr<LinesRepo> initRepoFromCommnand(const LinesRepo& sourceRepo, std::string_view commandResult);
 		static std::unique_ptr<LinesRepo> initRepoFromLineRange(const LinesRepo& sourceRepo, size_t indexStart, size_t count);
 		static std::unique_ptr<LinesRepo> initRepoFromTags(const LinesRepo& sourceRepo, const std::vector<std::string_view>& tags);
 
 	public:
-		~LinesRepo() = default;
+		~LinesRepo();
 
 		LinesRepo(const LinesRepo&) = delete;
 		LinesRepo& operator=(const LinesRepo&) = delete;
@@ -118,6 +127,9 @@ namespace la
 		size_t numFiles() const noexcept;
 		size_t numLines() const noexcept;
 		FlavorsRepo::Type flavor() const noexcept;
+		bool loadedFromCache() const noexcept;
+
+		std::optional<size_t> refresh();
 
 		FindContext searchText(std::string_view query, FindOptions options) const;
 		FindContext searchTextRegex(std::string_view query, FindOptions options) const;
@@ -141,8 +153,17 @@ namespace la
 		bool exportCommandNetworkPackets(ExportOptions options, std::string_view commandResult) const;
 
 	private:
-		LinesRepo(std::shared_ptr<FilesRepo> repoFiles);
-		LinesRepo(const LinesRepo& sourceRepo, std::vector<LogLine> logLines);
+		LinesRepo(std::shared_ptr<FilesRepo> repoFiles, CacheOptions cacheOptions);
+		LinesRepo(const LinesRepo& sourceRepo, const std::vector<size_t>& sourceLinesIndices);
+
+		void appendFilesData(const std::vector<std::string_view>& filesData);
+
+		//the first match from the start on (the start is used as is, so it must be inside the lines)
+		FindContext searchFrom(std::shared_ptr<const FindContext::Matcher> matcher, size_t startLine, size_t startLineOffset) const;
+
+		//indexes the lines which aren't yet in the search index, in the background (the searches use it once it has all of them)
+		void buildSearchIndex(bool storeIndex);
+		void stopSearchIndex();
 
 	private:
 		LinesTools m_linesTools;
@@ -151,6 +172,14 @@ namespace la
 		std::unordered_map<std::string_view, std::vector<CommandsRepo::CommandInfo>> m_cmds;
 
 		std::shared_ptr<FilesRepo> m_repoFiles;
+		bool m_ownsFiles{ false }; //repos created from other repos only have some of the lines of the files
+		bool m_loadedFromCache{ false }; //lines came from the index stored before (instead of being parsed)
+		bool m_cacheEnabled{ false };
+		std::string m_cacheFolderPath; //empty for next to the files
+
+		std::shared_ptr<TrigramIndex> m_searchIndex; //only for the repos with the files (and only changed by the builder while it runs)
+		std::thread m_searchIndexBuilder;
+		std::atomic<bool> m_searchIndexCancel{ false };
 	};
 }
 
@@ -0,0 +1,244 @@
+#include "lines_scanner.hpp"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define LA_LINES_SCANNER_X86
+	#include <immintrin.h>
+#endif
+
+#if defined(LA_LINES_SCANNER_X86) && !defined(_MSC_VER)
+	#define LA_LINES_SCANNER_TARGET(x) __attribute__((target(x)))
+#else
+	#define LA_LINES_SCANNER_TARGET(x)
+#endif
+
+namespace la
+{
+	namespace
+	{
+		//line breaks are searched in blocks of 64 bytes, each one resulting in a bitmask with a bit per byte
+		constexpr size_t BlockSize{ 64 };
+
+		inline unsigned int countTrailingZeros(uint64_t bits) noexcept
+		{
+#if defined(_MSC_VER)
+			unsigned long index{ 0 };
+	#if defined(_M_X64) || defined(_M_ARM64)
+			_BitScanForward64(&index, bits);
+	#else
+			if (!_BitScanForward(&index, static_cast<unsigned long>(bits)))
+			{
+				_BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+				index += 32;
+			}
+	#endif
+			return static_cast<unsigned int>(index);
+#else
+			return static_cast<unsigned int>(__builtin_ctzll(bits));
+#endif
+		}
+
+		inline uint64_t partialBlockBits(const char* block, const char* walkerEnd) noexcept
+		{
+			uint64_t bits{ 0 };
+			for (size_t i = 0; (i < BlockSize) && ((block + i) < walkerEnd); i++)
+			{
+				if ((block[i] == '\n') || (block[i] == '\r'))
+					bits |= (uint64_t{ 1 } << i);
+			}
+
+			return bits;
+		}
+
+		struct ScalarBlock
+		{
+			static uint64_t bits(const char* block) noexcept
+			{
+				return partialBlockBits(block, block + BlockSize);
+			}
+		};
+
+#if defined(LA_LINES_SCANNER_X86)
+		struct SSE2Block
+		{
+			LA_LINES_SCANNER_TARGET("sse2") static uint64_t bits(const char* block) noexcept
+			{
+				const auto lf = _mm_set1_epi8('\n');
+				const auto cr = _mm_set1_epi8('\r');
+
+				uint64_t bits{ 0 };
+				for (size_t i = 0; i < BlockSize; i += 16)
+				{
+					auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+					auto found = _mm_or_si128(_mm_cmpeq_epi8(chars, lf), _mm_cmpeq_epi8(chars, cr));
+					bits |= (static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(found))) << i);
+				}
+
+				return bits;
+			}
+		};
+
+		struct AVX2Block
+		{
+			LA_LINES_SCANNER_TARGET("avx2") static uint64_t bits(const char* block) noexcept
+			{
+				const auto lf = _mm256_set1_epi8('\n');
+				const auto cr = _mm256_set1_epi8('\r');
+
+				auto charsLow = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+				auto charsHigh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+				auto foundLow = _mm256_or_si256(_mm256_cmpeq_epi8(charsLow, lf), _mm256_cmpeq_epi8(charsLow, cr));
+				auto foundHigh = _mm256_or_si256(_mm256_cmpeq_epi8(charsHigh, lf), _mm256_cmpeq_epi8(charsHigh, cr));
+
+				return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(foundLow))) | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(foundHigh))) << 32);
+			}
+		};
+#endif
+
+		template<typename TBlock>
+		inline uint64_t blockBits(const char* block, const char* walkerEnd) noexcept
+		{
+			if (static_cast<size_t>(walkerEnd - block) >= BlockSize)
+				return TBlock::bits(block);
+
+			return partialBlockBits(block, walkerEnd);
+		}
+
+		template<typename TBlock>
+		inline size_t scanLines(const char*& walker, const char* walkerEnd, LinesScanner::Span* spans, size_t maxSpans) noexcept
+		{
+			size_t numSpans{ 0 };
+			auto lineStart = walker;
+
+			//pending line breaks of the current block (the ones before lineStart are already consumed)
+			auto block = lineStart;
+			auto bits = blockBits<TBlock>(block, walkerEnd);
+
+			while ((numSpans < maxSpans) && (lineStart < walkerEnd))
+			{
+				while ((bits == 0) && (static_cast<size_t>(walkerEnd - block) > BlockSize))
+				{
+					block += BlockSize;
+					bits = blockBits<TBlock>(block, walkerEnd);
+				}
+
+				//no more line breaks, the line goes until the end of the data
+				if (bits == 0)
+				{
+					spans[numSpans++] = { lineStart, walkerEnd };
+					lineStart = walkerEnd;
+					break;
+				}
+
+				auto lineEnd = block + countTrailingZeros(bits);
+				bits &= (bits - 1);
+
+				spans[numSpans++] = { lineStart, lineEnd };
+
+				//consume the line break and any '\0's for the next line (no line breaks can be skipped here)
+				lineStart = lineEnd + 1;
+				while ((lineStart < walkerEnd) && (lineStart[0] == '\0'))
+					lineStart++;
+			}
+
+			walker = lineStart;
+			return numSpans;
+		}
+
+		size_t scanLinesScalar(const char*& walker, const char* walkerEnd, LinesScanner::Span* spans, size_t maxSpans)
+		{
+			return scanLines<ScalarBlock>(walker, walkerEnd, spans, maxSpans);
+		}
+
+#if defined(LA_LINES_SCANNER_X86)
+		LA_LINES_SCANNER_TARGET("sse2") size_t scanLinesSSE2(const char*& walker, const char* walkerEnd, LinesScanner::Span* spans, size_t maxSpans)
+		{
+			return scanLines<SSE2Block>(walker, walkerEnd, spans, maxSpans);
+		}
+
+		LA_LINES_SCANNER_TARGET("avx2") size_t scanLinesAVX2(const char*& walker, const char* walkerEnd, LinesScanner::Span* spans, size_t maxSpans)
+		{
+			return scanLines<AVX2Block>(walker, walkerEnd, spans, maxSpans);
+		}
+#endif
+
+		LinesScanner::Level detectLevel() noexcept
+		{
+#if defined(LA_LINES_SCANNER_X86)
+	#if defined(_MSC_VER)
+			int info[4]{ 0 };
+			__cpuid(info, 0);
+			auto maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			auto hasSSE2 = ((info[3] & (1 << 26)) != 0);
+			auto hasAVX = ((info[2] & (1 << 28)) != 0) && ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0x6) == 0x6); //cpu support + os saves the ymm registers
+
+			if (hasAVX && (maxLeaf >= 7))
+			{
+				__cpuidex(info, 7, 0);
+				if ((info[1] & (1 << 5)) != 0)
+					return LinesScanner::Level::AVX2;
+			}
+
+			if (hasSSE2)
+				return LinesScanner::Level::SSE2;
+	#else
+			__builtin_cpu_init();
+
+			if (__builtin_cpu_supports("avx2"))
+				return LinesScanner::Level::AVX2;
+
+			if (__builtin_cpu_supports("sse2"))
+				return LinesScanner::Level::SSE2;
+	#endif
+#endif
+
+			return LinesScanner::Level::Scalar;
+		}
+
+		LinesScanner::ScanFunc selectScanFunc(LinesScanner::Level level) noexcept
+		{
+			switch (level)
+			{
+#if defined(LA_LINES_SCANNER_X86)
+			case LinesScanner::Level::AVX2:
+				return scanLinesAVX2;
+			case LinesScanner::Level::SSE2:
+				return scanLinesSSE2;
+#endif
+			default:
+				return scanLinesScalar;
+			}
+		}
+	}
+
+	LinesScanner::Level LinesScanner::level() noexcept
+	{
+		static const auto level{ detectLevel() };
+		return level;
+	}
+
+	LinesScanner::LinesScanner(const void* data, size_t dataSize) noexcept
+		: LinesScanner(data, dataSize, level())
+	{ }
+
+	LinesScanner::LinesScanner(const void* data, size_t dataSize, Level maxLevel) noexcept
+		: m_walker{ reinterpret_cast<const char*>(data) }
+		, m_walkerEnd{ reinterpret_cast<const char*>(data) + dataSize }
+		, m_scanFunc{ selectScanFunc((maxLevel < level()) ? maxLevel : level()) }
+	{ }
+
+	size_t LinesScanner::nextBatch(Batch& batch) noexcept
+	{
+		return m_scanFunc(m_walker, m_walkerEnd, batch.data(), batch.size());
+	}
+
+	bool LinesScanner::nextLine(Span& span) noexcept
+	{
+		return (m_scanFunc(m_walker, m_walkerEnd, &span, 1) > 0);
+	}
+}
@@ -0,0 +1,50 @@
+#ifndef LA_LINES_SCANNER_HPP
+#define LA_LINES_SCANNER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace la
+{
+	class LinesScanner final
+	{
+	public:
+		enum class Level : uint8_t { Scalar, SSE2, AVX2 };
+
+		struct Span
+		{
+			const char* start;
+			const char* end;
+		};
+
+		using Batch = std::array<Span, 256>;
+
+		using ScanFunc = size_t(*)(const char*& walker, const char* walkerEnd, Span* spans, size_t maxSpans);
+
+	public:
+		static Level level() noexcept;
+
+	public:
+		LinesScanner(const void* data, size_t dataSize) noexcept;
+
+		//the scan uses at most "maxLevel" (even if the cpu supports more), to compare the implementations
+		LinesScanner(const void* data, size_t dataSize, Level maxLevel) noexcept;
+
+		const char* position() const noexcept
+		{
+			return m_walker;
+		}
+
+		//a line ends in '\n' or '\r' (which isn't part of the span) and any '\0's after it are skipped
+		size_t nextBatch(Batch& batch) noexcept;
+		bool nextLine(Span& span) noexcept;
+
+	private:
+		const char* m_walker;
+		const char* m_walkerEnd;
+		ScanFunc m_scanFunc;
+	};
+}
+
+#endif
@@ -1,15 +1,311 @@
 #include "lines_tools.hpp"
+#include "utils.hpp"
+#include "text_searcher.hpp"
 
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
 #include <cassert>
+#include <cstring>
+#include <numeric>
 #include <algorithm>
 
 namespace la
 {
+	namespace
+	{
+		constexpr size_t InternBlockSize{ 64 * 1024 }; //lines interned by each worker
+		constexpr size_t SignatureValueMaxSize{ sizeof(uint64_t) }; //only short values (ids, counters, ...) are in the params signatures
+		constexpr size_t SearchBlockSize{ 64 * 1024 }; //lines searched by each worker
+		constexpr size_t MinIndexedSearchSize{ 4 * TrigramIndex::BlockSize }; //lines searched without the search index
+		constexpr size_t MaxLineEndingSize{ 2 }; //"\r\n"
+
+		//the sections of each interned column, in order (thread name, tag and method)
+		constexpr std::array<std::string_view(LogLine::*)() const noexcept, 3> InternedSections{ &LogLine::getSectionThreadName, &LogLine::getSectionTag, &LogLine::getSectionMethod };
+
+		//the line "next" starts right after the end of the line "prev" in memory (the bytes between them are a line ending)
+		bool areAdjacent(const LogLine& prev, const LogLine& next) noexcept
+		{
+			return ((next.dataStart >= prev.dataEnd()) && (static_cast<size_t>(next.dataStart - prev.dataEnd()) <= MaxLineEndingSize));
+		}
+	}
+
 	const std::vector<LogLine>& LinesTools::lines() const
 	{
 		return m_lines;
 	}
 
+	uint32_t LinesTools::Dictionary::find(std::string_view value) const noexcept
+	{
+		auto it = m_ids.find(value);
+		return (it != m_ids.end()) ? it->second : InvalidId;
+	}
+
+	std::tuple<uint32_t, uint32_t> LinesTools::Dictionary::findPrefixRanks(std::string_view prefix) const
+	{
+		auto itStart = std::partition_point(m_sortedIds.begin(), m_sortedIds.end(), [this, prefix](uint32_t id) { return (m_values[id] < prefix); });
+		auto itEnd = std::partition_point(itStart, m_sortedIds.end(), [this, prefix](uint32_t id) { return (m_values[id].substr(0, prefix.size()) == prefix); });
+
+		return { static_cast<uint32_t>(itStart - m_sortedIds.begin()), static_cast<uint32_t>(itEnd - m_sortedIds.begin()) };
+	}
+
+	uint32_t LinesTools::Dictionary::insert(std::string_view value)
+	{
+		auto [it, inserted] = m_ids.try_emplace(value, static_cast<uint32_t>(m_values.size()));
+		if (inserted)
+			m_values.push_back(value);
+
+		return it->second;
+	}
+
+	void LinesTools::Dictionary::sort()
+	{
+		m_sortedIds.resize(m_values.size());
+		std::iota(m_sortedIds.begin(), m_sortedIds.end(), 0);
+		std::sort(m_sortedIds.begin(), m_sortedIds.end(), [this](uint32_t left, uint32_t right) { return (m_values[left] < m_values[right]); });
+
+		m_ranks.resize(m_values.size());
+		for (uint32_t rank = 0; rank < m_sortedIds.size(); rank++)
+			m_ranks[m_sortedIds[rank]] = rank;
+	}
+
+	bool LinesTools::paramExtract(size_t lineIndex, uint32_t nameId, std::string_view& value) const noexcept
+	{
+		if (nameId == Dictionary::InvalidId)
+			return false;
+
+		auto it = m_params.begin() + m_paramsStart[lineIndex];
+		auto itEnd = m_params.begin() + m_paramsStart[lineIndex + 1];
+
+		if ((it != itEnd) && (it->nameId == Dictionary::InvalidId)) //params too long to be split
+			return m_lines[lineIndex].paramExtract(m_paramNames.value(nameId), value);
+
+		for (; it != itEnd; ++it)
+		{
+			if (it->nameId != nameId)
+				continue;
+
+			if (it->valueSize == Param::NoValue)
+				return false;
+
+			value = m_lines[lineIndex].getSectionParams().substr(it->valueOffset, it->valueSize);
+			return true;
+		}
+
+		return false;
+	}
+
+	uint32_t LinesTools::ParamsBlock::insertName(std::string_view name)
+	{
+		auto& [recentName, recentId] = recentNames[(name.size() + static_cast<uint8_t>(name.back())) % recentNames.size()];
+		if (recentName != name)
+		{
+			recentName = name;
+			recentId = names.insert(name);
+		}
+
+		return recentId;
+	}
+
+	uint64_t LinesTools::tokenizeParams(const LogLine& line, ParamsBlock& paramsBlock)
+	{
+		auto lineParams = line.getSectionParams();
+
+		//the offsets of the values must fit in the table, otherwise the line is marked and its lookups scan it (it also can't be rejected by its signature)
+		bool fits = (lineParams.size() < Param::NoValue);
+		if (!fits && !lineParams.empty())
+			paramsBlock.params.push_back({ Dictionary::InvalidId, 0, 0 });
+
+		uint64_t signature{ fits ? 0 : std::numeric_limits<uint64_t>::max() };
+
+		//the same rules as LogLine::paramExtract: every param ends in "; " (the last one can't be extracted otherwise)
+		size_t paramStart{ 0 };
+		while (paramStart < lineParams.size())
+		{
+			auto paramEnd = lineParams.find("; ", paramStart);
+			auto param = lineParams.substr(paramStart, (paramEnd != std::string_view::npos) ? (paramEnd - paramStart) : std::string_view::npos);
+
+			auto nameSize = param.find('=');
+			if ((nameSize != std::string_view::npos) && (nameSize > 0))
+			{
+				auto nameId = paramsBlock.insertName(param.substr(0, nameSize));
+
+				if (fits && (paramEnd != std::string_view::npos))
+				{
+					paramsBlock.params.push_back({ nameId, static_cast<uint16_t>(paramStart + nameSize + 1), static_cast<uint16_t>(param.size() - nameSize - 1) });
+					signature |= paramSignature(param.substr(0, nameSize), param.substr(nameSize + 1));
+				}
+				else if (fits)
+				{
+					paramsBlock.params.push_back({ nameId, 0, Param::NoValue });
+				}
+			}
+
+			if (paramEnd == std::string_view::npos)
+				break;
+
+			paramStart = paramEnd + 2;
+		}
+
+		return signature;
+	}
+
+	uint64_t LinesTools::paramSignature(uint32_t nameId) noexcept
+	{
+		return (uint64_t{ 1 } << (nameId % 32));
+	}
+
+	uint64_t LinesTools::paramSignature(std::string_view name, std::string_view value) noexcept
+	{
+		if (value.size() > SignatureValueMaxSize)
+			return 0;
+
+		uint64_t nameBits{ 0 }, valueBits{ 0 };
+		std::memcpy(&nameBits, name.data(), std::min(name.size(), sizeof(nameBits)));
+		std::memcpy(&valueBits, value.data(), value.size());
+
+		auto hash = ((nameBits * 0xC2B2AE3D27D4EB4Full) ^ valueBits ^ value.size()) * 0x9E3779B97F4A7C15ull;
+		return (uint64_t{ 1 } << (32 + (hash >> 59)));
+	}
+
+	void LinesTools::resizeHeaders(size_t numLines)
+	{
+		m_levels.resize(numLines);
+		m_threadIds.resize(numLines);
+		m_timestamps.resize(numLines);
+	}
+
+	void LinesTools::updateColumns(size_t lineIndexStart)
+	{
+		assert(m_levels.size() == m_lines.size());
+		lineIndexStart = std::min({ lineIndexStart, m_tags.ids.size(), m_lines.size() });
+
+		std::array<InternedColumn*, 3> internedColumns{ &m_threadNames, &m_tags, &m_methods };
+		for (auto internedColumn : internedColumns)
+			internedColumn->ids.resize(m_lines.size());
+
+		if (m_paramsStart.empty())
+			m_paramsStart.push_back(0);
+
+		m_params.resize(m_paramsStart[lineIndexStart]);
+		m_paramsStart.resize(m_lines.size() + 1);
+		m_paramsSignatures.resize(m_lines.size());
+
+		//each block of lines is interned on its own dictionaries (in parallel)...
+		auto numBlocks = (m_lines.size() - lineIndexStart + InternBlockSize - 1) / InternBlockSize;
+		std::vector<std::array<Dictionary, 3>> blocksDictionaries(numBlocks);
+		std::vector<ParamsBlock> paramsBlocks(numBlocks);
+
+		utils::Parallel::forEach(numBlocks, [this, lineIndexStart, &internedColumns, &blocksDictionaries, &paramsBlocks](size_t block)
+		{
+			auto blockStart = lineIndexStart + (block * InternBlockSize);
+			auto blockEnd = std::min(blockStart + InternBlockSize, m_lines.size());
+
+			//consecutive lines often have the same values (e.g. the same thread), which skips the lookup
+			std::array<std::string_view, 3> lastValues;
+			std::array<uint32_t, 3> lastIds{ Dictionary::InvalidId, Dictionary::InvalidId, Dictionary::InvalidId };
+
+			for (auto i = blockStart; i < blockEnd; i++)
+			{
+				const auto& line = m_lines[i];
+
+				for (size_t j = 0; j < InternedSections.size(); j++)
+				{
+					auto value = (line.*InternedSections[j])();
+					if ((lastIds[j] == Dictionary::InvalidId) || (value != lastValues[j]))
+					{
+						lastValues[j] = value;
+						lastIds[j] = blocksDictionaries[block][j].insert(value);
+					}
+
+					internedColumns[j]->ids[i] = lastIds[j];
+				}
+
+				m_paramsStart[i] = static_cast<uint32_t>(paramsBlocks[block].params.size()); //relative to the block (until they are merged)
+				m_paramsSignatures[i] = tokenizeParams(line, paramsBlocks[block]);
+			}
+		});
+
+		//... which are then merged, in order, into the repo ones (so ids don't depend on how the work was split)
+		std::vector<std::array<std::vector<uint32_t>, 3>> blocksIds(numBlocks);
+		for (size_t block = 0; block < numBlocks; block++)
+		{
+			for (size_t j = 0; j < InternedSections.size(); j++)
+			{
+				const auto& blockDictionary = blocksDictionaries[block][j];
+
+				auto& blockIds = blocksIds[block][j];
+				blockIds.resize(blockDictionary.size());
+
+				for (uint32_t id = 0; id < blockDictionary.size(); id++)
+					blockIds[id] = internedColumns[j]->dictionary.insert(blockDictionary.value(id));
+			}
+		}
+
+		std::vector<std::vector<uint32_t>> blocksParamNameIds(numBlocks);
+		std::vector<size_t> blocksParamsStart(numBlocks);
+		for (size_t block = 0; block < numBlocks; block++)
+		{
+			const auto& blockParamNames = paramsBlocks[block].names;
+
+			auto& blockParamNameIds = blocksParamNameIds[block];
+			blockParamNameIds.resize(blockParamNames.size());
+
+			for (uint32_t id = 0; id < blockParamNames.size(); id++)
+				blockParamNameIds[id] = m_paramNames.insert(blockParamNames.value(id));
+
+			blocksParamsStart[block] = m_params.size();
+			m_params.resize(m_params.size() + paramsBlocks[block].params.size());
+		}
+
+		m_paramsStart.back() = static_cast<uint32_t>(m_params.size());
+
+		utils::Parallel::forEach(numBlocks, [this, lineIndexStart, &internedColumns, &blocksIds, &blocksParamNameIds, &blocksParamsStart, &paramsBlocks](size_t block)
+		{
+			auto blockStart = lineIndexStart + (block * InternBlockSize);
+			auto blockEnd = std::min(blockStart + InternBlockSize, m_lines.size());
+
+			for (size_t j = 0; j < InternedSections.size(); j++)
+			{
+				auto& ids = internedColumns[j]->ids;
+				for (auto i = blockStart; i < blockEnd; i++)
+					ids[i] = blocksIds[block][j][ids[i]];
+			}
+
+			const auto& blockParams = paramsBlocks[block].params;
+			for (auto i = blockStart; i < blockEnd; i++)
+			{
+				//the start of the params of the line is still relative to the block (and the next line is in the next block, for the last one)
+				auto paramStart = m_paramsStart[i];
+				auto paramEnd = ((i + 1) < blockEnd) ? m_paramsStart[i + 1] : static_cast<uint32_t>(blockParams.size());
+
+				for (auto j = paramStart; j < paramEnd; j++)
+				{
+					auto param = blockParams[j];
+					if (param.nameId != Dictionary::InvalidId)
+					{
+						param.nameId = blocksParamNameIds[block][param.nameId];
+						m_paramsSignatures[i] |= paramSignature(param.nameId);
+					}
+
+					m_params[blocksParamsStart[block] + j] = param;
+				}
+
+				m_paramsStart[i] += static_cast<uint32_t>(blocksParamsStart[block]);
+			}
+		});
+
+		for (auto internedColumn : internedColumns)
+			internedColumn->dictionary.sort();
+
+		std::lock_guard lock{ m_commandIndicesMutex };
+		if (m_taskIndex)
+			m_taskIndex->truncate(lineIndexStart);
+		if (m_httpRequestIndex)
+			m_httpRequestIndex->truncate(lineIndexStart);
+	}
+
 	LinesTools::SearchResult LinesTools::windowSearch(LineIndexRange targetRange, size_t startCharacterIndex, const std::function<const char* (const char*, const char*)>& cbSearch) const
 	{
 		if (targetRange.empty())
@@ -18,8 +314,8 @@ namespace la
 		//as an optimization, do the first loop manually to avoid the check of "startCharacterIndex"
 		if (startCharacterIndex > 0)
 		{
-			auto lineDataStart = m_lines[targetRange.start].data.start + startCharacterIndex;
-			auto lineDataEnd = m_lines[targetRange.start].data.end;
+			auto lineDataStart = m_lines[targetRange.start].dataStart + startCharacterIndex;
+			auto lineDataEnd = m_lines[targetRange.start].dataEnd();
 
 			if (lineDataStart < lineDataEnd)
 			{
@@ -29,7 +325,7 @@ namespace la
 					SearchResult result{
 						true,
 						targetRange.start,
-						static_cast<size_t>(targetPtr - m_lines[targetRange.start].data.start)
+						static_cast<size_t>(targetPtr - m_lines[targetRange.start].dataStart)
 					};
 
 					return result;
@@ -41,8 +337,8 @@ namespace la
 
 		for (; targetRange.start < targetRange.end; targetRange.start++)
 		{
-			auto lineDataStart = m_lines[targetRange.start].data.start;
-			auto lineDataEnd = m_lines[targetRange.start].data.end;
+			auto lineDataStart = m_lines[targetRange.start].dataStart;
+			auto lineDataEnd = m_lines[targetRange.start].dataEnd();
 
 			auto targetPtr = cbSearch(lineDataStart, lineDataEnd);
 			if (!targetPtr || (targetPtr == lineDataEnd))
@@ -51,13 +347,178 @@ namespace la
 			return SearchResult{
 				true,
 				targetRange.start,
-				static_cast<size_t>(targetPtr - m_lines[targetRange.start].data.start)
+				static_cast<size_t>(targetPtr - m_lines[targetRange.start].dataStart)
 			};
 		}
 
 		return {};
 	}
 
+	void LinesTools::setSearchIndex(std::shared_ptr<const TrigramIndex> searchIndex) noexcept
+	{
+		std::atomic_store(&m_searchIndex, std::move(searchIndex));
+	}
+
+	std::shared_ptr<const TrigramIndex> LinesTools::searchIndex() const noexcept
+	{
+		return std::atomic_load(&m_searchIndex);
+	}
+
+	std::shared_ptr<const TaskIndex> LinesTools::taskIndex() const
+	{
+		std::lock_guard lock{ m_commandIndicesMutex };
+
+		if (!m_taskIndex)
+			m_taskIndex = std::make_shared<TaskIndex>();
+
+		m_taskIndex->extend(*this);
+		return m_taskIndex;
+	}
+
+	std::shared_ptr<const HTTPRequestIndex> LinesTools::httpRequestIndex() const
+	{
+		std::lock_guard lock{ m_commandIndicesMutex };
+
+		if (!m_httpRequestIndex)
+			m_httpRequestIndex = std::make_shared<HTTPRequestIndex>();
+
+		m_httpRequestIndex->extend(*this);
+		return m_httpRequestIndex;
+	}
+
+	LinesTools::SearchResult LinesTools::windowSearchParallel(LineIndexRange targetRange, size_t startCharacterIndex, const std::function<const char* (const char*, const char*)>& cbSearch, std::string_view requiredText) const
+	{
+		//the first lines are searched without the index, which is enough when the matches are close to each other (e.g. when going through all of them)...
+		LineIndexRange firstRange{ targetRange.start, std::min(targetRange.end, targetRange.start + MinIndexedSearchSize) };
+
+		auto result = windowSearch(firstRange, startCharacterIndex, cbSearch);
+		if (result.valid || (firstRange.end >= targetRange.end))
+			return result;
+
+		//... then only the ranges which may have a match are searched, in order
+		for (auto range : candidateRanges({ firstRange.end, targetRange.end }, requiredText))
+		{
+			result = searchParallel(range, 0, cbSearch);
+			if (result.valid)
+				return result;
+		}
+
+		return {};
+	}
+
+	LinesTools::SearchResult LinesTools::searchParallel(LineIndexRange targetRange, size_t startCharacterIndex, const std::function<const char* (const char*, const char*)>& cbSearch) const
+	{
+		//the first block is searched alone, which is enough when the matches are close to each other (e.g. when going through all of them)
+		LineIndexRange firstRange{ targetRange.start, std::min(targetRange.end, targetRange.start + SearchBlockSize) };
+
+		auto result = windowSearch(firstRange, startCharacterIndex, cbSearch);
+		if (result.valid || (firstRange.end >= targetRange.end))
+			return result;
+
+		targetRange.start = firstRange.end;
+
+		//the workers take the blocks in order and skip the ones after a block with a match (the first match is in the lowest block with one)
+		auto numBlocks = (targetRange.numLines() + SearchBlockSize - 1) / SearchBlockSize;
+		std::vector<SearchResult> blocksResults(numBlocks);
+		std::atomic<size_t> firstMatchBlock{ numBlocks };
+
+		utils::Parallel::forEach(numBlocks, [this, targetRange, &cbSearch, &blocksResults, &firstMatchBlock](size_t block)
+		{
+			if (block > firstMatchBlock)
+				return;
+
+			auto blockStart = targetRange.start + (block * SearchBlockSize);
+			auto blockEnd = std::min(blockStart + SearchBlockSize, targetRange.end);
+
+			blocksResults[block] = windowSearch({ blockStart, blockEnd }, 0, cbSearch);
+			if (!blocksResults[block].valid)
+				return;
+
+			auto curFirstMatchBlock = firstMatchBlock.load();
+			while (block < curFirstMatchBlock)
+			{
+				if (firstMatchBlock.compare_exchange_weak(curFirstMatchBlock, block))
+					break;
+			}
+		});
+
+		if (firstMatchBlock >= numBlocks)
+			return {};
+
+		return blocksResults[firstMatchBlock];
+	}
+
+	void LinesTools::windowSearchAll(LineIndexRange targetRange, size_t matchSize, const std::function<const char* (const char*, const char*)>& cbSearch, const std::function<void(size_t lineIndex, size_t lineOffset)>& cbMatch) const
+	{
+		while (!targetRange.empty())
+		{
+			//the run of lines searched with one call (a match across two of them is dropped)
+			auto runStart = targetRange.start;
+			auto runEnd = runStart + 1;
+			if (matchSize > 0)
+			{
+				while ((runEnd < targetRange.end) && areAdjacent(m_lines[runEnd - 1], m_lines[runEnd]))
+					runEnd++;
+			}
+
+			targetRange.start = runEnd;
+
+			auto itLine = m_lines.begin() + runStart;
+			auto itRunEnd = m_lines.begin() + runEnd;
+			auto dataEnd = m_lines[runEnd - 1].dataEnd();
+
+			for (auto walker = m_lines[runStart].dataStart; walker < dataEnd; )
+			{
+				auto targetPtr = cbSearch(walker, dataEnd);
+				if (!targetPtr || (targetPtr >= dataEnd))
+					break;
+
+				walker = targetPtr + 1;
+
+				//the matches come in order, so the line of each one is after the line of the previous one
+				itLine = std::partition_point(itLine, itRunEnd, [targetPtr](const LogLine& line) { return (line.dataEnd() <= targetPtr); });
+				if ((itLine == itRunEnd) || (targetPtr < itLine->dataStart) || (static_cast<size_t>(itLine->dataEnd() - targetPtr) < matchSize))
+					continue;
+
+				cbMatch(static_cast<size_t>(itLine - m_lines.begin()), static_cast<size_t>(targetPtr - itLine->dataStart));
+			}
+		}
+	}
+
+	void LinesTools::windowSearchAllParallel(LineIndexRange targetRange, size_t matchSize, const std::function<const char* (const char*, const char*)>& cbSearch, const std::function<void(size_t lineIndex, size_t lineOffset)>& cbMatch, std::string_view requiredText) const
+	{
+		//the ranges which may have a match are split in blocks
+		std::vector<LineIndexRange> blocks;
+		for (auto range : candidateRanges(targetRange, requiredText))
+		{
+			for (auto blockStart = range.start; blockStart < range.end; blockStart += SearchBlockSize)
+				blocks.push_back({ blockStart, std::min(blockStart + SearchBlockSize, range.end) });
+		}
+
+		if (blocks.size() <= 1)
+		{
+			for (auto block : blocks)
+				windowSearchAll(block, matchSize, cbSearch, cbMatch);
+
+			return;
+		}
+
+		//the matches of each block are kept until all the blocks are searched, then given in order
+		std::vector<std::vector<SearchResult>> blocksResults(blocks.size());
+
+		utils::Parallel::forEach(blocks.size(), [this, matchSize, &cbSearch, &blocks, &blocksResults](size_t block)
+		{
+			auto& blockResults = blocksResults[block];
+			windowSearchAll(blocks[block], matchSize, cbSearch, [&blockResults](size_t lineIndex, size_t lineOffset) { blockResults.push_back({ true, lineIndex, lineOffset }); });
+		});
+
+		for (const auto& blockResults : blocksResults)
+		{
+			for (const auto& result : blockResults)
+				cbMatch(result.lineIndex, result.lineOffset);
+		}
+	}
+
 	std::vector<size_t> LinesTools::windowFindAll(LineIndexRange targetRange, std::string_view contentQuery) const
 	{
 		std::vector<size_t> lineIndices;
@@ -65,37 +526,31 @@ namespace la
 		if (contentQuery.empty())
 			return lineIndices;
 
-		std::boyer_moore_searcher bmSearcher(contentQuery.begin(), contentQuery.end());
+		TextSearcher textSearcher{ contentQuery, false };
 
-		while (true)
+		for (auto range : candidateRanges(targetRange, contentQuery))
 		{
-			auto result = windowSearch(targetRange, 0, [&bmSearcher](const char* dataStart, const char* dataEnd) { return std::search(dataStart, dataEnd, bmSearcher); });
-			if (!result.valid)
-				break;
-
-			targetRange.start = result.lineIndex + 1;
-			lineIndices.push_back(result.lineIndex);
+			windowSearchAll(range, textSearcher.size(), [&textSearcher](const char* dataStart, const char* dataEnd) { return textSearcher(dataStart, dataEnd); }, [&lineIndices](size_t lineIndex, size_t)
+			{
+				if (lineIndices.empty() || (lineIndices.back() != lineIndex))
+					lineIndices.push_back(lineIndex);
+			});
 		}
 
 		return lineIndices;
 	}
 
-	std::vector<size_t> LinesTools::windowFindAll(LineIndexRange targetRange, const std::regex& contentQuery) const
+	std::vector<size_t> LinesTools::windowFindAll(LineIndexRange targetRange, const RegexSearcher& contentQuery) const
 	{
 		std::vector<size_t> lineIndices;
 
-		while (true)
+		for (auto range : candidateRanges(targetRange, contentQuery.literal()))
 		{
-			auto result = windowSearch(targetRange, 0, [&contentQuery](const char* dataStart, const char* dataEnd)
+			windowSearchAll(range, contentQuery.fixedSize(), [&contentQuery](const char* dataStart, const char* dataEnd) { return contentQuery(dataStart, dataEnd); }, [&lineIndices](size_t lineIndex, size_t)
 			{
-				std::cmatch match;
-				return std::regex_search(dataStart, dataEnd, match, contentQuery) ? match[0].first : nullptr;
+				if (lineIndices.empty() || (lineIndices.back() != lineIndex))
+					lineIndices.push_back(lineIndex);
 			});
-			if (!result.valid)
-				break;
-
-			targetRange.start = result.lineIndex + 1;
-			lineIndices.push_back(result.lineIndex);
 		}
 
 		return lineIndices;
@@ -106,25 +561,166 @@ namespace la
 		if (contentQuery.empty())
 			return std::nullopt;
 
-		std::boyer_moore_searcher bmSearcher(contentQuery.begin(), contentQuery.end());
+		TextSearcher textSearcher{ contentQuery, false };
 
-		auto result = windowSearch(targetRange, 0, [&bmSearcher](const char* dataStart, const char* dataEnd) { return std::search(dataStart, dataEnd, bmSearcher); });
-		if (!result.valid)
-			return std::nullopt;
+		return findFirst(targetRange, contentQuery, [&textSearcher](const char* dataStart, const char* dataEnd) { return textSearcher(dataStart, dataEnd); });
+	}
 
-		return result.lineIndex;
+	std::optional<size_t> LinesTools::windowFindFirst(LineIndexRange targetRange, const RegexSearcher& contentQuery) const
+	{
+		return findFirst(targetRange, contentQuery.literal(), [&contentQuery](const char* dataStart, const char* dataEnd) { return contentQuery(dataStart, dataEnd); });
 	}
 
-	std::optional<size_t> LinesTools::windowFindFirst(LineIndexRange targetRange, const std::regex& contentQuery) const
+	void LinesTools::windowFindAllMulti(LineIndexRange targetRange, const MultiSearcher& contentQueries, const std::function<bool(size_t queryIndex, size_t lineIndex)>& cbMatch) const
 	{
-		auto result = windowSearch(targetRange, 0, [&contentQuery](const char* dataStart, const char* dataEnd)
+		std::vector<size_t> lineQueries;
+
+		for (auto range : candidateRanges(targetRange, contentQueries))
 		{
-			std::cmatch match;
-			return std::regex_search(dataStart, dataEnd, match, contentQuery) ? match[0].first : nullptr;
-		});
-		if (!result.valid)
-			return std::nullopt;
+			while (!range.empty())
+			{
+				//the run of lines searched with one call (a match across two of them is dropped)
+				auto runStart = range.start;
+				auto runEnd = runStart + 1;
+				while ((runEnd < range.end) && areAdjacent(m_lines[runEnd - 1], m_lines[runEnd]))
+					runEnd++;
+
+				range.start = runEnd;
+
+				auto itLine = m_lines.begin() + runStart;
+				auto itRunEnd = m_lines.begin() + runEnd;
+
+				while (itLine != itRunEnd)
+				{
+					//the run is searched until the first line which may have a match...
+					auto candidate = contentQueries.findCandidate(itLine->dataStart, m_lines[runEnd - 1].dataEnd());
+
+					auto itMatchLine = std::partition_point(itLine, itRunEnd, [candidate](const LogLine& line) { return (line.dataEnd() <= candidate); });
+					if (itMatchLine == itRunEnd)
+						break;
+
+					if (candidate < itMatchLine->dataStart)
+					{
+						itLine = itMatchLine;
+						continue;
+					}
+
+					//... which is searched alone for all its matches, given sorted and without repetitions
+					lineQueries.clear();
+					contentQueries(itMatchLine->dataStart, itMatchLine->dataEnd(), [&lineQueries](size_t queryIndex, const char*)
+					{
+						lineQueries.push_back(queryIndex);
+						return true;
+					});
+
+					std::sort(lineQueries.begin(), lineQueries.end());
+					lineQueries.erase(std::unique(lineQueries.begin(), lineQueries.end()), lineQueries.end());
+
+					auto lineIndex = static_cast<size_t>(itMatchLine - m_lines.begin());
+					for (auto queryIndex : lineQueries)
+					{
+						if (!cbMatch(queryIndex, lineIndex))
+							return;
+					}
+
+					itLine = itMatchLine + 1;
+				}
+			}
+		}
+	}
+
+	std::optional<size_t> LinesTools::findFirst(LineIndexRange targetRange, std::string_view requiredText, const std::function<const char* (const char*, const char*)>& cbSearch) const
+	{
+		//the first lines are searched without the index, the match is often close to the start of the range
+		LineIndexRange firstRange{ targetRange.start, std::min(targetRange.end, targetRange.start + MinIndexedSearchSize) };
+
+		auto result = windowSearch(firstRange, 0, cbSearch);
+		if (result.valid)
+			return result.lineIndex;
+
+		for (auto range : candidateRanges({ firstRange.end, targetRange.end }, requiredText))
+		{
+			result = windowSearch(range, 0, cbSearch);
+			if (result.valid)
+				return result.lineIndex;
+		}
+
+		return std::nullopt;
+	}
+
+	std::vector<LinesTools::LineIndexRange> LinesTools::candidateRanges(LineIndexRange targetRange, std::string_view requiredText) const
+	{
+		//a few blocks are searched faster than their candidates are found
+		auto searchIndex = this->searchIndex();
+		if (!searchIndex || (targetRange.numLines() <= MinIndexedSearchSize))
+			return { targetRange };
+
+		auto numIndexedLines = std::min(searchIndex->numLines(), m_lines.size());
+		auto blockStart = targetRange.start / TrigramIndex::BlockSize;
+		auto blockEnd = (std::min(targetRange.end, numIndexedLines) + TrigramIndex::BlockSize - 1) / TrigramIndex::BlockSize;
+
+		auto blocks = searchIndex->candidateBlocks(requiredText, static_cast<uint32_t>(blockStart), static_cast<uint32_t>(std::max(blockStart, blockEnd)));
+		if (!blocks.has_value())
+			return { targetRange };
+
+		std::vector<LineIndexRange> ranges;
+		auto addRange = [&ranges, targetRange](size_t start, size_t end)
+		{
+			start = std::max(start, targetRange.start);
+			end = std::min(end, targetRange.end);
+			if (start >= end)
+				return;
+
+			if (!ranges.empty() && (ranges.back().end == start))
+				ranges.back().end = end;
+			else
+				ranges.push_back({ start, end });
+		};
+
+		for (auto block : blocks.value())
+		{
+			auto blockLineStart = static_cast<size_t>(block) * TrigramIndex::BlockSize;
+			addRange(blockLineStart, std::min(blockLineStart + TrigramIndex::BlockSize, numIndexedLines));
+		}
+
+		//the lines after the indexed ones are all searched
+		addRange(numIndexedLines, targetRange.end);
+
+		return ranges;
+	}
+
+	std::vector<LinesTools::LineIndexRange> LinesTools::candidateRanges(LineIndexRange targetRange, const MultiSearcher& anyText) const
+	{
+		//the text all the matches have is enough...
+		if (!anyText.literal().empty())
+			return candidateRanges(targetRange, anyText.literal());
+
+		//... otherwise the lines may have any of the texts
+		std::vector<LineIndexRange> textsRanges;
+		for (size_t i = 0; i < anyText.numQueries(); i++)
+		{
+			//an empty text is never found
+			if (anyText.query(i).empty())
+				continue;
+
+			auto textRanges = candidateRanges(targetRange, anyText.query(i));
+			if ((textRanges.size() == 1) && (textRanges.front().start == targetRange.start) && (textRanges.front().end == targetRange.end))
+				return textRanges;
+
+			textsRanges.insert(textsRanges.end(), textRanges.begin(), textRanges.end());
+		}
+
+		std::sort(textsRanges.begin(), textsRanges.end(), [](const LineIndexRange& a, const LineIndexRange& b) { return (a.start < b.start); });
+
+		std::vector<LineIndexRange> ranges;
+		for (auto range : textsRanges)
+		{
+			if (!ranges.empty() && (range.start <= ranges.back().end))
+				ranges.back().end = std::max(ranges.back().end, range.end);
+			else
+				ranges.push_back(range);
+		}
 
-		return result.lineIndex;
+		return ranges;
 	}
 }
@@ -2,19 +2,51 @@
 #define LA_LINES_TOOLS_HPP
 
 #include "log_line.hpp"
-
-#include <regex>
+#include "task_index.hpp"
+#include "trigram_index.hpp"
+#include "http_request_index.hpp"
+#include "multi_searcher.hpp"
+#include "regex_searcher.hpp"
+
+#include <array>
+#include <tuple>
+#include <mutex>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <optional>
 #include <functional>
 #include <string_view>
+#include <unordered_map>
 
 namespace la
 {
 	class LinesTools
 	{
 	public:
-		enum class FilterType : int8_t { LogLevel, ThreadId, ThreadName, Tag, Method, Msg, Params };
+		enum class FilterType : int8_t { LogLevel, ThreadId, ThreadName, Tag, Method, Msg, Params, HasParam };
+
+		//distinct values of a section (a bundle only has a few hundred tags, for example), each one with an id
+		class Dictionary
+		{
+		public:
+			static constexpr uint32_t InvalidId{ std::numeric_limits<uint32_t>::max() };
+
+			size_t size() const noexcept { return m_values.size(); }
+			std::string_view value(uint32_t id) const noexcept { return m_values[id]; }
+			uint32_t rank(uint32_t id) const noexcept { return m_ranks[id]; } //position of the value when sorted
+
+			uint32_t find(std::string_view value) const noexcept;
+			std::tuple<uint32_t, uint32_t> findPrefixRanks(std::string_view prefix) const; //values starting with "prefix" are a range of ranks
+
+			uint32_t insert(std::string_view value);
+			void sort();
+
+		private:
+			std::vector<std::string_view> m_values;
+			std::unordered_map<std::string_view, uint32_t> m_ids;
+			std::vector<uint32_t> m_sortedIds, m_ranks;
+		};
 
 		template<FilterType TFilterType, class TFilterValue, LogLine::MatchType TFilterValueMatchType = LogLine::MatchType::Exact>
 		class FilterParam;
@@ -27,7 +59,11 @@ namespace la
 				: m_value{ value }
 			{ }
 
-			constexpr bool operator()(const LogLine& line) const noexcept { return (line.level == m_value); }
+			static constexpr bool IsColumnar{ true };
+
+			constexpr void resolve(const LinesTools&) noexcept { }
+
+			bool operator()(const LinesTools& linesTools, size_t lineIndex) const noexcept { return (linesTools.m_levels[lineIndex] == m_value); }
 
 		private:
 			LogLevel m_value;
@@ -41,12 +77,68 @@ namespace la
 				: m_value{ value }
 			{ }
 
-			constexpr bool operator()(const LogLine& line) const noexcept { return (line.threadId == m_value); }
+			static constexpr bool IsColumnar{ true };
+
+			constexpr void resolve(const LinesTools&) noexcept { }
+
+			bool operator()(const LinesTools& linesTools, size_t lineIndex) const noexcept { return (linesTools.m_threadIds[lineIndex] == m_value); }
 
 		private:
 			int32_t m_value;
 		};
 
+		//lines with the param "name" (or "name=value"), most lines are rejected by their params signature alone
+		template<>
+		class FilterParam<FilterType::HasParam, std::string_view, LogLine::MatchType::Exact>
+		{
+		public:
+			FilterParam(std::string_view value) noexcept
+				: m_name{ value.substr(0, value.find('=')) }
+			{
+				if (m_name.size() < value.size())
+					m_value = value.substr(m_name.size() + 1);
+			}
+
+			static constexpr bool IsColumnar{ true };
+
+			void resolve(const LinesTools& linesTools)
+			{
+				m_nameId = linesTools.m_paramNames.find(m_name);
+				if (m_nameId == Dictionary::InvalidId)
+					m_signature = std::numeric_limits<uint64_t>::max(); //no line has it
+				else
+					m_signature = paramSignature(m_nameId) | (m_value.has_value() ? paramSignature(m_name, *m_value) : 0);
+			}
+
+			bool operator()(const LogLine& line) const noexcept
+			{
+				std::string_view value;
+				return (line.paramExtract(m_name, value) && (!m_value.has_value() || (value == *m_value)));
+			}
+
+			bool operator()(const LinesTools& linesTools, size_t lineIndex) const noexcept
+			{
+				if (!mayMatch(linesTools, lineIndex))
+					return false;
+
+				std::string_view value;
+				return (linesTools.paramExtract(lineIndex, m_nameId, value) && (!m_value.has_value() || (value == *m_value)));
+			}
+
+			//false when the signature of the line rules it out (true doesn't mean the line has the param, a different one may share its bits)
+			bool mayMatch(const LinesTools& linesTools, size_t lineIndex) const noexcept
+			{
+				return ((linesTools.m_paramsSignatures[lineIndex] & m_signature) == m_signature);
+			}
+
+		private:
+			std::string_view m_name;
+			std::optional<std::string_view> m_value;
+
+			uint32_t m_nameId{ Dictionary::InvalidId };
+			uint64_t m_signature{ 0 };
+		};
+
 		template<FilterType TFilterType, LogLine::MatchType TFilterValueMatchType>
 		class FilterParam<TFilterType, std::string_view, TFilterValueMatchType>
 		{
@@ -58,6 +150,39 @@ namespace la
 				: m_value{ value }
 			{ }
 
+			//exact and prefix matches of the interned sections are checked with their ids (the query is resolved once per iteration)
+			static constexpr bool IsColumnar{ ((TFilterType == FilterType::ThreadName) || (TFilterType == FilterType::Tag) || (TFilterType == FilterType::Method)) &&
+				((TFilterValueMatchType == LogLine::MatchType::Exact) || (TFilterValueMatchType == LogLine::MatchType::StartsWith)) };
+
+			void resolve(const LinesTools& linesTools)
+			{
+				if constexpr (IsColumnar)
+				{
+					const auto& dictionary = linesTools.internedColumn<TFilterType>().dictionary;
+
+					if constexpr (TFilterValueMatchType == LogLine::MatchType::Exact)
+						m_id = dictionary.find(m_value);
+					else
+						std::tie(m_rankStart, m_rankEnd) = dictionary.findPrefixRanks(m_value);
+				}
+			}
+
+			bool operator()(const LinesTools& linesTools, size_t lineIndex) const noexcept
+			{
+				const auto& column = linesTools.internedColumn<TFilterType>();
+				auto id = column.ids[lineIndex];
+
+				if constexpr (TFilterValueMatchType == LogLine::MatchType::Exact)
+				{
+					return (id == m_id);
+				}
+				else
+				{
+					auto rank = column.dictionary.rank(id);
+					return ((rank >= m_rankStart) && (rank < m_rankEnd));
+				}
+			}
+
 			constexpr bool operator()(const LogLine& line) const noexcept
 			{
 				if constexpr (TFilterType == FilterType::ThreadName)
@@ -76,6 +201,9 @@ namespace la
 
 		private:
 			std::string_view m_value;
+
+			uint32_t m_id{ Dictionary::InvalidId };
+			uint32_t m_rankStart{ 0 }, m_rankEnd{ 0 };
 		};
 
 		template <class... TParams>
@@ -91,6 +219,43 @@ namespace la
 				return std::apply([&line](auto... param) { return (param(line) && ...); }, m_params);
 			}
 
+			void resolve(const LinesTools& linesTools)
+			{
+				std::apply([&linesTools](auto&... param) { (param.resolve(linesTools), ...); }, m_params);
+			}
+
+			bool operator()(const LinesTools& linesTools, size_t lineIndex) const noexcept
+			{
+				//the filters with a column are checked first, so the (much wider) line is only read if they all match
+				return std::apply([&linesTools, lineIndex](const auto&... param)
+				{
+					if (!(matchColumn(param, linesTools, lineIndex) && ...))
+						return false;
+
+					const auto& line = linesTools.m_lines[lineIndex];
+					return (matchLine(param, line) && ...);
+				}, m_params);
+			}
+
+		private:
+			template<class TParam>
+			static bool matchColumn(const TParam& param, const LinesTools& linesTools, size_t lineIndex) noexcept
+			{
+				if constexpr (TParam::IsColumnar)
+					return param(linesTools, lineIndex);
+				else
+					return true;
+			}
+
+			template<class TParam>
+			static bool matchLine(const TParam& param, const LogLine& line) noexcept
+			{
+				if constexpr (TParam::IsColumnar)
+					return true;
+				else
+					return param(line);
+			}
+
 		private:
 			std::tuple<TParams...> m_params;
 		};
@@ -125,6 +290,67 @@ namespace la
 
 		const std::vector<LogLine>& lines() const;
 
+		//the header of each line (given by the parser with it) is only kept here, each field in its own contiguous array
+		const std::vector<LogLevel>& levels() const noexcept { return m_levels; }
+		const std::vector<int32_t>& threadIds() const noexcept { return m_threadIds; }
+		const std::vector<int64_t>& timestamps() const noexcept { return m_timestamps; }
+
+		LogLineHeader header(size_t lineIndex) const noexcept { return { m_timestamps[lineIndex], m_threadIds[lineIndex], m_levels[lineIndex] }; }
+
+		//the headers are set along with the lines (resizing to the lines first), before updateColumns
+		void resizeHeaders(size_t numLines);
+		void setHeader(size_t lineIndex, const LogLineHeader& header) noexcept
+		{
+			m_timestamps[lineIndex] = header.timestamp;
+			m_threadIds[lineIndex] = header.threadId;
+			m_levels[lineIndex] = header.level;
+		}
+
+		//the thread name, tag and method of the lines are interned, in per section dictionaries (ids are kept when lines are added)
+		const Dictionary& threadNames() const noexcept { return m_threadNames.dictionary; }
+		const Dictionary& tags() const noexcept { return m_tags.dictionary; }
+		const Dictionary& methods() const noexcept { return m_methods.dictionary; }
+		const std::vector<uint32_t>& threadNameIds() const noexcept { return m_threadNames.ids; }
+		const std::vector<uint32_t>& tagIds() const noexcept { return m_tags.ids; }
+		const std::vector<uint32_t>& methodIds() const noexcept { return m_methods.ids; }
+
+		//the params ("name=value; ") of the lines are split once, their names interned (a lookup compares a few ids instead of scanning the params)
+		const Dictionary& paramNames() const noexcept { return m_paramNames; }
+
+		bool paramExtract(size_t lineIndex, uint32_t nameId, std::string_view& value) const noexcept;
+
+		template<class T>
+		bool paramExtractAs(size_t lineIndex, uint32_t nameId, T& value) const
+		{
+			std::string_view valueStr;
+			if (!paramExtract(lineIndex, nameId, valueStr))
+				return false;
+
+			return LogLine::paramValueAs<T>(valueStr, value);
+		}
+
+		template<class T>
+		bool paramCheck(size_t lineIndex, uint32_t nameId, const T& value) const
+		{
+			T paramValue;
+			if (!paramExtractAs<T>(lineIndex, nameId, paramValue))
+				return false;
+
+			return (paramValue == value);
+		}
+
+		//must be called after the lines change (the columns of the lines before "lineIndexStart" are kept)
+		void updateColumns(size_t lineIndexStart);
+
+		//the searches given a text all their matches have only go through the blocks of lines with it, when the lines are indexed
+		//the index can be set from any thread (a search uses the one set when it starts), but it must not change while set
+		void setSearchIndex(std::shared_ptr<const TrigramIndex> searchIndex) noexcept;
+		std::shared_ptr<const TrigramIndex> searchIndex() const noexcept;
+
+		//the lifecycle of the COMLib tasks and the lines of the HTTP requests, indexed on the first use by any thread (and then kept up to date as the lines change)
+		std::shared_ptr<const TaskIndex> taskIndex() const;
+		std::shared_ptr<const HTTPRequestIndex> httpRequestIndex() const;
+
 		template<class TFilterCb, class... TParams>
 		size_t windowIterate(LineIndexRange targetRange, FilterCollection<TParams...> filter, TFilterCb&& filterCb) const
 		{
@@ -136,14 +362,15 @@ namespace la
 			if (targetRange.end > m_lines.size())
 				targetRange.end = m_lines.size();
 
+			filter.resolve(*this);
+
 			size_t curIndex{ 0 };
 			size_t linesProcessed{ 0 };
 			while (targetRange.start < targetRange.end)
 			{
 				linesProcessed++;
 
-				const auto& line = m_lines[targetRange.start];
-				if (filter(line) && !filterCb(curIndex++, line, targetRange.start))
+				if (filter(*this, targetRange.start) && !filterCb(curIndex++, m_lines[targetRange.start], targetRange.start))
 					break;
 
 				targetRange.start++;
@@ -153,25 +380,34 @@ namespace la
 		}
 
 		SearchResult windowSearch(LineIndexRange targetRange, size_t startCharacterIndex, const std::function<const char* (const char*, const char*)>& cbSearch) const;
+		SearchResult windowSearchParallel(LineIndexRange targetRange, size_t startCharacterIndex, const std::function<const char* (const char*, const char*)>& cbSearch, std::string_view requiredText = {}) const; //"cbSearch" is called from several threads
+
+		//calls "cbMatch" with every match of "cbSearch", in order: the lines which follow each other in memory are searched at once, when the size of the matches is known ("matchSize" > 0)
+		void windowSearchAll(LineIndexRange targetRange, size_t matchSize, const std::function<const char* (const char*, const char*)>& cbSearch, const std::function<void(size_t lineIndex, size_t lineOffset)>& cbMatch) const;
+		void windowSearchAllParallel(LineIndexRange targetRange, size_t matchSize, const std::function<const char* (const char*, const char*)>& cbSearch, const std::function<void(size_t lineIndex, size_t lineOffset)>& cbMatch, std::string_view requiredText = {}) const; //"cbSearch" is called from several threads, "cbMatch" only from this one
 
 		std::vector<size_t> windowFindAll(LineIndexRange targetRange, std::string_view contentQuery) const;
-		std::vector<size_t> windowFindAll(LineIndexRange targetRange, const std::regex& contentQuery) const;
+		std::vector<size_t> windowFindAll(LineIndexRange targetRange, const RegexSearcher& contentQuery) const;
 		std::optional<size_t> windowFindFirst(LineIndexRange targetRange, std::string_view contentQuery) const;
-		std::optional<size_t> windowFindFirst(LineIndexRange targetRange, const std::regex& contentQuery) const;
+		std::optional<size_t> windowFindFirst(LineIndexRange targetRange, const RegexSearcher& contentQuery) const;
+
+		//calls "cbMatch" once per query found in a line, in order (by line, then by query), until it returns false: all the queries are searched in a single pass
+		void windowFindAllMulti(LineIndexRange targetRange, const MultiSearcher& contentQueries, const std::function<bool(size_t queryIndex, size_t lineIndex)>& cbMatch) const;
 
 		template<class TFilterCb, class... TParams>
 		size_t iterateBackwards(size_t lineIndexStart, FilterCollection<TParams...> filter, TFilterCb&& filterCb) const
 		{
 			static_assert(std::is_invocable_r_v<bool, TFilterCb, size_t, LogLine, size_t>);
 
+			filter.resolve(*this);
+
 			size_t curIndex{ 0 };
 			size_t linesProcessed{ 0 };
 			while (true)
 			{
 				linesProcessed++;
 
-				auto& line = m_lines[lineIndexStart];
-				if (filter(line) && !filterCb(curIndex++, line, lineIndexStart))
+				if (filter(*this, lineIndexStart) && !filterCb(curIndex++, m_lines[lineIndexStart], lineIndexStart))
 					break;
 
 				if (lineIndexStart == 0)
@@ -187,14 +423,15 @@ namespace la
 		{
 			static_assert(std::is_invocable_r_v<bool, TFilterCb, size_t, LogLine, size_t>);
 
+			filter.resolve(*this);
+
 			size_t curIndex{ 0 };
 			size_t linesProcessed{ 0 };
 			while (lineIndexStart < m_lines.size())
 			{
 				linesProcessed++;
 
-				auto& line = m_lines[lineIndexStart];
-				if (filter(line) && !filterCb(curIndex++, line, lineIndexStart))
+				if (filter(*this, lineIndexStart) && !filterCb(curIndex++, m_lines[lineIndexStart], lineIndexStart))
 					break;
 
 				lineIndexStart++;
@@ -203,8 +440,75 @@ namespace la
 			return linesProcessed;
 		}
 
+	private:
+		struct InternedColumn
+		{
+			Dictionary dictionary;
+			std::vector<uint32_t> ids;
+		};
+
+		//a param of a line, its value is relative to the params of the line
+		struct Param
+		{
+			static constexpr uint16_t NoValue{ std::numeric_limits<uint16_t>::max() }; //the value doesn't end in "; "
+
+			uint32_t nameId;
+			uint16_t valueOffset, valueSize;
+		};
+
+		//the params of a block of lines, split by one worker (lines have only a few distinct names, so a small cache skips most of the lookups)
+		struct ParamsBlock
+		{
+			Dictionary names;
+			std::vector<Param> params;
+			std::array<std::tuple<std::string_view, uint32_t>, 64> recentNames;
+
+			uint32_t insertName(std::string_view name);
+		};
+
+		template<FilterType TFilterType>
+		const InternedColumn& internedColumn() const noexcept
+		{
+			if constexpr (TFilterType == FilterType::ThreadName)
+				return m_threadNames;
+			else if constexpr (TFilterType == FilterType::Tag)
+				return m_tags;
+			else
+				return m_methods;
+		}
+
+		static uint64_t tokenizeParams(const LogLine& line, ParamsBlock& paramsBlock); //returns the signature of the values
+
+		SearchResult searchParallel(LineIndexRange targetRange, size_t startCharacterIndex, const std::function<const char* (const char*, const char*)>& cbSearch) const;
+		std::optional<size_t> findFirst(LineIndexRange targetRange, std::string_view requiredText, const std::function<const char* (const char*, const char*)>& cbSearch) const;
+
+		//the parts of the range which may have the text (ignoring the ascii case), all of it unless the lines are indexed and the text is long enough
+		std::vector<LineIndexRange> candidateRanges(LineIndexRange targetRange, std::string_view requiredText) const;
+		std::vector<LineIndexRange> candidateRanges(LineIndexRange targetRange, const MultiSearcher& anyText) const; //the parts which may have any of the texts
+
+		//the low half of a signature has a bit per param name, the high half a bit per param with a short value
+		static uint64_t paramSignature(uint32_t nameId) noexcept;
+		static uint64_t paramSignature(std::string_view name, std::string_view value) noexcept;
+
 	private:
 		const std::vector<LogLine>& m_lines;
+
+		std::vector<LogLevel> m_levels;
+		std::vector<int32_t> m_threadIds;
+		std::vector<int64_t> m_timestamps;
+
+		InternedColumn m_threadNames, m_tags, m_methods;
+
+		Dictionary m_paramNames;
+		std::vector<Param> m_params;
+		std::vector<uint32_t> m_paramsStart; //the params of a line are [m_paramsStart[lineIndex], m_paramsStart[lineIndex + 1])
+		std::vector<uint64_t> m_paramsSignatures; //the signatures of all the params of each line, OR'ed
+
+		std::shared_ptr<const TrigramIndex> m_searchIndex; //only accessed with the atomic functions
+
+		mutable std::mutex m_commandIndicesMutex;
+		mutable std::shared_ptr<TaskIndex> m_taskIndex; //null until it is used
+		mutable std::shared_ptr<HTTPRequestIndex> m_httpRequestIndex; //null until it is used
 	};
 }
 
@@ -9,7 +9,7 @@ namespace la
 		if (param.empty())
 			return false;
 
-		std::string_view params = { data.start + sectionParams.offset, sectionParams.size };
+		auto params = getSectionParams();
 
 		while (!params.empty())
 		{
@@ -34,6 +34,8 @@ namespace la
 
 						if (((walker + 1) < walkerEnd) && (walker[1] == ' '))
 							break;
+
+						walker++; //a ';' inside the value
 					}
 
 					if (walker >= walkerEnd)
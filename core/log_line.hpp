@@ -1,7 +1,10 @@
 #ifndef LA_LOG_LINE_HPP
 #define LA_LOG_LINE_HPP
 
+#include <array>
+#include <algorithm>
 #include <string>
+#include <limits>
 #include <cstdint>
 #include <charconv>
 #include <string_view>
@@ -15,52 +18,117 @@ namespace la
 	{
 		enum class MatchType : uint8_t { Exact, StartsWith, EndsWith, Contains };
 
+		enum class SectionType : uint8_t { ThreadName, Tag, Method, Msg, Params };
+
+		//the sections are stored with their offset in the line, except for the params which are stored as their distance from the end of the message
+		//only the message and the params can be long, the sizes of the other sections take 2 bytes
+		struct Sections
+		{
+			std::array<uint16_t, 4> offsets; //thread name, tag, method and message
+			std::array<uint16_t, 3> shortSizes; //thread name, tag and method
+			uint16_t paramsGap;
+			std::array<uint32_t, 2> longSizes; //message and params
+		};
+
+		//the content of the line is kept as its start and 32-bit size (longer multiline content is cut there), so a line takes 40 bytes
+		const char* dataStart;
+		uint32_t dataSize;
 		int32_t id;
+		Sections sections;
 
-		LogLevel level;
-		int32_t threadId;
-		int64_t timestamp;
+		//the timestamp, thread id and level of the lines are in the columns of LinesTools (given by the parser in a LogLineHeader)
 
-		struct {
-			const char* start;
-			const char* end;
+		const char* dataEnd() const noexcept { return dataStart + dataSize; }
+		void setDataEnd(const char* end) noexcept { dataSize = static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(end - dataStart), std::numeric_limits<uint32_t>::max())); }
+
+		std::string_view toStr() const noexcept { return { dataStart, dataSize }; }
+
+		uint32_t sectionSize(SectionType type) const noexcept
+		{
+			auto index = static_cast<size_t>(type);
+			return (index < sections.shortSizes.size()) ? sections.shortSizes[index] : sections.longSizes[index - sections.shortSizes.size()];
+		}
+
+		size_t sectionOffset(SectionType type) const noexcept
+		{
+			if (type == SectionType::Params)
+				return static_cast<size_t>(sections.offsets[static_cast<size_t>(SectionType::Msg)]) + sections.longSizes[0] + sections.paramsGap;
 
-			bool empty() const noexcept
+			return sections.offsets[static_cast<size_t>(type)];
+		}
+
+		std::string_view getSection(SectionType type) const noexcept { return { dataStart + sectionOffset(type), sectionSize(type) }; }
+
+		//false when the bounds of the section don't fit (the params are set after the message, and start at or after its end)
+		bool setSection(SectionType type, size_t offset, size_t size) noexcept
+		{
+			auto index = static_cast<size_t>(type);
+			if (type == SectionType::Params)
 			{
-				return (end == start);
+				auto msgEnd = sectionOffset(SectionType::Msg) + sectionSize(SectionType::Msg);
+				if ((offset < msgEnd) || ((offset - msgEnd) > std::numeric_limits<uint16_t>::max()))
+					return false;
+
+				if (!setSectionSize(type, size))
+					return false;
+
+				sections.paramsGap = static_cast<uint16_t>(offset - msgEnd);
+				return true;
 			}
 
-			size_t size() const noexcept
+			if (offset > std::numeric_limits<uint16_t>::max())
+				return false;
+
+			if (!setSectionSize(type, size))
+				return false;
+
+			sections.offsets[index] = static_cast<uint16_t>(offset);
+			return true;
+		}
+
+		//the params are moved with the end of the message (only meant for the message when the params are empty)
+		bool setSectionSize(SectionType type, size_t size) noexcept
+		{
+			auto index = static_cast<size_t>(type);
+			if (index < sections.shortSizes.size())
 			{
-				return (end - start);
-			}
+				if (size > std::numeric_limits<uint16_t>::max())
+					return false;
 
-		} data;
+				sections.shortSizes[index] = static_cast<uint16_t>(size);
+				return true;
+			}
 
-		struct {
-			uint16_t offset;
-			uint32_t size;
-		} sectionThreadName, sectionTag, sectionMethod, sectionMsg, sectionParams;
+			if (size > std::numeric_limits<uint32_t>::max())
+				return false;
 
-		std::string_view toStr() const noexcept { return { data.start, static_cast<size_t>(data.end - data.start) }; }
+			sections.longSizes[index - sections.shortSizes.size()] = static_cast<uint32_t>(size);
+			return true;
+		}
 
-		std::string_view getSectionThreadName() const noexcept { return { data.start + sectionThreadName.offset, sectionThreadName.size }; }
-		std::string_view getSectionTag() const noexcept { return { data.start + sectionTag.offset, sectionTag.size }; }
-		std::string_view getSectionMethod() const noexcept { return { data.start + sectionMethod.offset, sectionMethod.size }; }
-		std::string_view getSectionMsg() const noexcept { return { data.start + sectionMsg.offset, sectionMsg.size }; }
-		std::string_view getSectionParams() const noexcept { return { data.start + sectionParams.offset, sectionParams.size }; }
+		std::string_view getSectionThreadName() const noexcept { return getSection(SectionType::ThreadName); }
+		std::string_view getSectionTag() const noexcept { return getSection(SectionType::Tag); }
+		std::string_view getSectionMethod() const noexcept { return getSection(SectionType::Method); }
+		std::string_view getSectionMsg() const noexcept { return getSection(SectionType::Msg); }
+		std::string_view getSectionParams() const noexcept { return getSection(SectionType::Params); }
 
 		bool paramExtract(std::string_view param, std::string_view& value) const noexcept;
 
 		template<class T>
 		bool paramExtractAs(std::string_view param, T& value) const
 		{
-			static_assert(std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string> || std::is_arithmetic_v<T>);
-
 			std::string_view valueStr;
 			if (!paramExtract(param, valueStr))
 				return false;
 
+			return paramValueAs<T>(valueStr, value);
+		}
+
+		template<class T>
+		static bool paramValueAs(std::string_view valueStr, T& value)
+		{
+			static_assert(std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string> || std::is_arithmetic_v<T>);
+
 			if constexpr (std::is_same_v<T, std::string_view>)
 			{
 				value = valueStr;
@@ -91,7 +159,7 @@ namespace la
 		template<MatchType TMatchType>
 		bool checkSectionThreadName(std::string_view name) const noexcept
 		{
-			std::string_view curName{ data.start + sectionThreadName.offset, sectionThreadName.size };
+			std::string_view curName{ getSectionThreadName() };
 
 			if constexpr (TMatchType == MatchType::Exact)
 				return (curName == name);
@@ -108,7 +176,7 @@ namespace la
 		template<MatchType TMatchType>
 		bool checkSectionTag(std::string_view tag) const noexcept
 		{
-			std::string_view curTag{ data.start + sectionTag.offset, sectionTag.size };
+			std::string_view curTag{ getSectionTag() };
 
 			if constexpr (TMatchType == MatchType::Exact)
 				return (curTag == tag);
@@ -125,7 +193,7 @@ namespace la
 		template<MatchType TMatchType>
 		bool checkSectionMethod(std::string_view method) const noexcept
 		{
-			std::string_view curMethod{ data.start + sectionMethod.offset, sectionMethod.size };
+			std::string_view curMethod{ getSectionMethod() };
 
 			if constexpr (TMatchType == MatchType::Exact)
 				return (curMethod == method);
@@ -142,7 +210,7 @@ namespace la
 		template<MatchType TMatchType>
 		bool checkSectionMsg(std::string_view msg) const noexcept
 		{
-			std::string_view curMsg{ data.start + sectionMsg.offset, sectionMsg.size };
+			std::string_view curMsg{ getSectionMsg() };
 
 			if constexpr (TMatchType == MatchType::Exact)
 				return (curMsg == msg);
@@ -159,7 +227,7 @@ namespace la
 		template<MatchType TMatchType>
 		bool checkSectionParams(std::string_view params) const noexcept
 		{
-			std::string_view curParams{ data.start + sectionParams.offset, sectionParams.size };
+			std::string_view curParams{ getSectionParams() };
 
 			if constexpr (TMatchType == MatchType::Exact)
 				return (curParams == params);
@@ -175,6 +243,15 @@ namespace la
 	};
 
 	static_assert(std::is_trivial_v<LogLine>);
+	static_assert((sizeof(void*) != 8) || (sizeof(LogLine) == 40));
+
+	//the fields of a line which aren't kept in the LogLine but in the columns of LinesTools, given by the parser with the line
+	struct LogLineHeader
+	{
+		int64_t timestamp;
+		int32_t threadId;
+		LogLevel level;
+	};
 }
 
 #endif
@@ -25,7 +25,8 @@ namespace la
 				if (!std::filesystem::is_regular_file(path))
 					return;
 
-				m_hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				//files may still be written (or rotated) by whoever is logging
+				m_hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
 				if (m_hFile == INVALID_HANDLE_VALUE)
 					return;
 			}
@@ -35,15 +36,16 @@ namespace la
 				return;
 
 			m_fileData = MapViewOfFile(m_hFileMapping, FILE_MAP_READ, 0, 0, 0);
+			if (!m_fileData)
+				return;
 
+			//the file size (the view is rounded up to whole pages)
 			{
-				MEMORY_BASIC_INFORMATION memInfo;
-				std::memset(&memInfo, 0, sizeof(MEMORY_BASIC_INFORMATION));
-
-				if (VirtualQuery(m_fileData, &memInfo, sizeof(MEMORY_BASIC_INFORMATION)) != sizeof(MEMORY_BASIC_INFORMATION))
+				LARGE_INTEGER fileSize;
+				if (!GetFileSizeEx(m_hFile, &fileSize))
 					return;
 
-				m_fileSize = static_cast<size_t>(memInfo.RegionSize);
+				m_fileSize = static_cast<size_t>(fileSize.QuadPart);
 			}
 		}
 
@@ -0,0 +1,120 @@
+#include "multi_searcher.hpp"
+
+#include <algorithm>
+
+namespace la
+{
+	namespace
+	{
+		constexpr size_t MinLiteralSize{ 3 }; //shorter literals reject too little data to pay for their search
+
+		//the longest text which is in all the queries (the empty ones are skipped, as they have no matches)
+		std::string_view commonLiteral(const std::vector<std::string>& queries)
+		{
+			std::vector<std::string_view> texts;
+			for (const auto& query : queries)
+			{
+				if (!query.empty())
+					texts.push_back(query);
+			}
+
+			if (texts.empty())
+				return {};
+
+			//the literal is a part of the shortest query, the longest ones are tried first
+			auto itShortest = std::min_element(texts.begin(), texts.end(), [](std::string_view a, std::string_view b) { return (a.size() < b.size()); });
+			auto shortest = *itShortest;
+
+			for (auto size = shortest.size(); size >= MinLiteralSize; size--)
+			{
+				for (size_t start = 0; (start + size) <= shortest.size(); start++)
+				{
+					auto literal = shortest.substr(start, size);
+					if (std::all_of(texts.begin(), texts.end(), [literal](std::string_view text) { return (text.find(literal) != std::string_view::npos); }))
+						return literal;
+				}
+			}
+
+			return {};
+		}
+	}
+
+	MultiSearcher::MultiSearcher(const std::vector<std::string>& queries)
+		: m_queries{ queries }
+		, m_states(1)
+		, m_sameQueries(queries.size(), NoQuery)
+	{
+		if (auto literal = commonLiteral(m_queries); !literal.empty())
+			m_literal.emplace(literal, false);
+
+		//the trie of the queries
+		for (size_t queryIndex = 0; queryIndex < m_queries.size(); queryIndex++)
+		{
+			const auto& query = m_queries[queryIndex];
+			if (query.empty())
+				continue;
+
+			uint32_t state{ 0 };
+			for (auto c : query)
+			{
+				auto byte = static_cast<uint8_t>(c);
+				if (nextState(state, byte))
+					continue;
+
+				auto child = static_cast<uint32_t>(m_states.size());
+				m_states.emplace_back();
+				m_states[child].byte = byte;
+				m_states[child].nextSibling = m_states[state].firstChild;
+				m_states[state].firstChild = child;
+
+				if (state == 0)
+					m_rootNext[byte] = child;
+
+				state = child;
+			}
+
+			m_sameQueries[queryIndex] = m_states[state].query;
+			m_states[state].query = static_cast<uint32_t>(queryIndex);
+		}
+
+		//the suffixes of the states, which are visited by depth (the suffixes are shallower, so they are done before)
+		std::vector<uint32_t> pending;
+		for (auto child = m_states[0].firstChild; child != 0; child = m_states[child].nextSibling)
+			pending.push_back(child);
+
+		for (size_t i = 0; i < pending.size(); i++)
+		{
+			auto state = pending[i];
+			for (auto child = m_states[state].firstChild; child != 0; child = m_states[child].nextSibling)
+			{
+				auto byte = m_states[child].byte;
+
+				auto fail = m_states[state].fail;
+				while ((fail != 0) && !nextState(fail, byte))
+					fail = m_states[fail].fail;
+
+				if (fail == 0)
+					fail = m_rootNext[byte];
+
+				m_states[child].fail = fail;
+				m_states[child].nextOutput = (m_states[fail].query != NoQuery) ? fail : m_states[fail].nextOutput;
+				pending.push_back(child);
+			}
+		}
+	}
+
+	const char* MultiSearcher::findCandidate(const char* dataStart, const char* dataEnd) const
+	{
+		if (m_literal.has_value())
+			return m_literal.value()(dataStart, dataEnd);
+
+		auto candidate = dataEnd;
+		(*this)(dataStart, dataEnd, [&candidate](size_t, const char* matchStart)
+		{
+			candidate = matchStart;
+			return false;
+		});
+
+		return candidate;
+	}
+}
@@ -0,0 +1,108 @@
+#ifndef LA_MULTI_SEARCHER_HPP
+#define LA_MULTI_SEARCHER_HPP
+
+#include "text_searcher.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace la
+{
+	//finds several texts in a single pass over the data (an aho-corasick automaton, with the case respected)
+	//when all the texts have a long enough part in common (e.g. "| id=7;"), it is searched first to skip the data without any match
+	class MultiSearcher final
+	{
+	public:
+		explicit MultiSearcher(const std::vector<std::string>& queries);
+
+		size_t numQueries() const noexcept
+		{
+			return m_queries.size();
+		}
+
+		std::string_view query(size_t queryIndex) const noexcept
+		{
+			return m_queries[queryIndex];
+		}
+
+		//the text all the matches have (empty when there is none long enough)
+		std::string_view literal() const noexcept
+		{
+			return m_literal.has_value() ? m_literal.value().query() : std::string_view{};
+		}
+
+		//a position in the data which may be in a match: in the text all the matches have, or at the start of the first match ("dataEnd" when there is none)
+		const char* findCandidate(const char* dataStart, const char* dataEnd) const;
+
+		//calls "cbMatch(queryIndex, matchStart)" with each match, in the order they end, until it returns false (empty queries have no matches)
+		template<class TMatchCb>
+		bool operator()(const char* dataStart, const char* dataEnd, TMatchCb&& cbMatch) const
+		{
+			uint32_t state{ 0 };
+			for (auto walker = dataStart; walker < dataEnd; walker++)
+			{
+				auto byte = static_cast<uint8_t>(*walker);
+				while ((state != 0) && !nextState(state, byte))
+					state = m_states[state].fail;
+
+				if (state == 0)
+					state = m_rootNext[byte];
+
+				//the queries which end here are the ones of the state and the ones of its suffixes
+				for (auto outputState = (m_states[state].query != NoQuery) ? state : m_states[state].nextOutput; outputState != 0; outputState = m_states[outputState].nextOutput)
+				{
+					for (auto queryIndex = m_states[outputState].query; queryIndex != NoQuery; queryIndex = m_sameQueries[queryIndex])
+					{
+						if (!cbMatch(static_cast<size_t>(queryIndex), walker + 1 - m_queries[queryIndex].size()))
+							return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		static constexpr uint32_t NoQuery{ 0xFFFFFFFF };
+
+		//a node of the trie of the queries (0 is the root)
+		struct State
+		{
+			uint32_t firstChild{ 0 };
+			uint32_t nextSibling{ 0 };
+			uint32_t fail{ 0 }; //the state of the longest suffix which is also in the trie
+			uint32_t nextOutput{ 0 }; //the state of the longest suffix where a query ends
+			uint32_t query{ NoQuery }; //the first query which ends here
+			uint8_t byte{ 0 };
+		};
+
+		//moves to the child of the state with the byte (returns false, without moving, when there is none)
+		bool nextState(uint32_t& state, uint8_t byte) const noexcept
+		{
+			for (auto child = m_states[state].firstChild; child != 0; child = m_states[child].nextSibling)
+			{
+				if (m_states[child].byte == byte)
+				{
+					state = child;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+	private:
+		std::vector<std::string> m_queries;
+		std::optional<TextSearcher> m_literal; //the text all the queries have
+
+		std::vector<State> m_states;
+		std::array<uint32_t, 256> m_rootNext{ }; //the transitions of the root, for all the bytes (most of the data doesn't leave it)
+		std::vector<uint32_t> m_sameQueries; //the next query equal to each one
+	};
+}
+
+#endif
@@ -0,0 +1,567 @@
+#include "regex_searcher.hpp"
+
+#include <tuple>
+#include <limits>
+
+namespace la
+{
+	namespace
+	{
+		constexpr size_t MinLiteralSize{ 3 }; //shorter literals reject too little data to pay for their search
+
+		using ByteSet = std::bitset<256>;
+
+		struct Atom
+		{
+			ByteSet bytes;
+			bool isLiteral{ false }; //a single byte (and its other case when the case is ignored)
+			char value{ 0 };
+		};
+
+		//the atoms which follow each other in every match, split in runs by what has no fixed size (groups, quantifiers, anchors, ...)
+		struct PatternAtoms
+		{
+			std::vector<std::vector<Atom>> runs = std::vector<std::vector<Atom>>(1);
+			bool isFixed{ true };
+		};
+
+		ByteSet byteRange(unsigned char low, unsigned char high) noexcept
+		{
+			ByteSet bytes;
+			for (unsigned int value = low; value <= high; value++)
+				bytes.set(value);
+
+			return bytes;
+		}
+
+		ByteSet foldCase(ByteSet bytes) noexcept
+		{
+			for (unsigned int value = 'a'; value <= 'z'; value++)
+			{
+				auto upperValue = value - ('a' - 'A');
+				if (bytes[value] || bytes[upperValue])
+					bytes.set(value).set(upperValue);
+			}
+
+			return bytes;
+		}
+
+		//"\d", "\w", "\s" and their complements
+		std::optional<ByteSet> classEscape(char escape) noexcept
+		{
+			switch (escape)
+			{
+			case 'd':
+				return byteRange('0', '9');
+			case 'D':
+				return ~byteRange('0', '9');
+			case 'w':
+				return byteRange('a', 'z') | byteRange('A', 'Z') | byteRange('0', '9') | byteRange('_', '_');
+			case 'W':
+				return ~(byteRange('a', 'z') | byteRange('A', 'Z') | byteRange('0', '9') | byteRange('_', '_'));
+			case 's':
+				return byteRange('\t', '\r') | byteRange(' ', ' ');
+			case 'S':
+				return ~(byteRange('\t', '\r') | byteRange(' ', ' '));
+			default:
+				return std::nullopt;
+			}
+		}
+
+		//the byte of an escape ("i" is after the escape character), nothing for the ones which aren't a single byte
+		std::optional<char> escapedByte(char escape, std::string_view pattern, size_t& i) noexcept
+		{
+			auto hexValue = [](char value) -> int
+			{
+				if ((value >= '0') && (value <= '9'))
+					return value - '0';
+				if ((value >= 'a') && (value <= 'f'))
+					return value - 'a' + 10;
+				if ((value >= 'A') && (value <= 'F'))
+					return value - 'A' + 10;
+				return -1;
+			};
+
+			switch (escape)
+			{
+			case 'n':
+				return '\n';
+			case 'r':
+				return '\r';
+			case 't':
+				return '\t';
+			case 'f':
+				return '\f';
+			case 'v':
+				return '\v';
+			case '0':
+				if ((i < pattern.size()) && (pattern[i] >= '0') && (pattern[i] <= '9'))
+					return std::nullopt;
+				return '\0';
+			case 'x':
+			{
+				if ((i + 2) > pattern.size())
+					return std::nullopt;
+
+				auto high = hexValue(pattern[i]);
+				auto low = hexValue(pattern[i + 1]);
+				if ((high < 0) || (low < 0))
+					return std::nullopt;
+
+				i += 2;
+				return static_cast<char>((high << 4) | low);
+			}
+			default:
+				if (((escape >= 'a') && (escape <= 'z')) || ((escape >= 'A') && (escape <= 'Z')) || ((escape >= '0') && (escape <= '9')))
+					return std::nullopt;
+				return escape;
+			}
+		}
+
+		//a quantifier, if any, after an atom (1 to 1 when there is none), false when it's malformed
+		bool parseQuantifier(std::string_view pattern, size_t& i, size_t& min, size_t& max) noexcept
+		{
+			constexpr auto Unbounded{ std::numeric_limits<size_t>::max() };
+
+			min = max = 1;
+			if (i >= pattern.size())
+				return true;
+
+			switch (pattern[i])
+			{
+			case '*':
+				std::tie(min, max) = std::make_tuple(0, Unbounded);
+				break;
+			case '+':
+				std::tie(min, max) = std::make_tuple(1, Unbounded);
+				break;
+			case '?':
+				std::tie(min, max) = std::make_tuple(0, 1);
+				break;
+			case '{':
+			{
+				auto end = pattern.find('}', i);
+				if (end == std::string_view::npos)
+					return false;
+
+				auto bounds = pattern.substr(i + 1, end - i - 1);
+				auto separator = bounds.find(',');
+
+				auto parseBound = [](std::string_view bound, size_t& value)
+				{
+					if (bound.empty())
+						return false;
+
+					value = 0;
+					for (auto digit : bound)
+					{
+						if ((digit < '0') || (digit > '9'))
+							return false;
+						value = (value * 10) + static_cast<size_t>(digit - '0');
+					}
+
+					return true;
+				};
+
+				if (!parseBound(bounds.substr(0, separator), min))
+					return false;
+
+				if (separator == std::string_view::npos)
+					max = min;
+				else if (separator == (bounds.size() - 1))
+					max = Unbounded;
+				else if (!parseBound(bounds.substr(separator + 1), max))
+					return false;
+
+				i = end;
+				break;
+			}
+			default:
+				return true;
+			}
+
+			i++;
+
+			//lazy
+			if ((i < pattern.size()) && (pattern[i] == '?'))
+				i++;
+
+			return true;
+		}
+
+		//the bytes of a class ("i" is after the '['), "supported" is false for the ones with what isn't a set of bytes (the end is still found), false when it's malformed
+		bool parseClass(std::string_view pattern, size_t& i, bool ignoreCase, ByteSet& bytes, bool& supported) noexcept
+		{
+			supported = true;
+			bytes.reset();
+
+			auto negated = ((i < pattern.size()) && (pattern[i] == '^'));
+			if (negated)
+				i++;
+
+			while (true)
+			{
+				if (i >= pattern.size())
+					return false;
+
+				auto value = pattern[i++];
+				if (value == ']')
+					break;
+
+				if (value == '[')
+				{
+					//"[:alpha:]" and the like
+					auto end = pattern.find(']', i);
+					if (end == std::string_view::npos)
+						return false;
+
+					supported = false;
+					i = end + 1;
+					continue;
+				}
+
+				if (value == '\\')
+				{
+					if (i >= pattern.size())
+						return false;
+
+					auto escape = pattern[i++];
+					if (auto escapeBytes = classEscape(escape); escapeBytes.has_value())
+					{
+						bytes |= escapeBytes.value();
+						continue;
+					}
+
+					auto escapeValue = escapedByte(escape, pattern, i);
+					if (!escapeValue.has_value())
+					{
+						supported = false;
+						continue;
+					}
+
+					value = escapeValue.value();
+				}
+
+				//range
+				if (((i + 1) < pattern.size()) && (pattern[i] == '-') && (pattern[i + 1] != ']'))
+				{
+					i++;
+
+					auto highValue = pattern[i++];
+					if (highValue == '\\')
+					{
+						if (i >= pattern.size())
+							return false;
+
+						auto escapeValue = escapedByte(pattern[i++], pattern, i);
+						if (!escapeValue.has_value())
+						{
+							supported = false;
+							continue;
+						}
+
+						highValue = escapeValue.value();
+					}
+
+					if (static_cast<unsigned char>(highValue) < static_cast<unsigned char>(value))
+						return false;
+
+					bytes |= byteRange(static_cast<unsigned char>(value), static_cast<unsigned char>(highValue));
+					continue;
+				}
+
+				bytes.set(static_cast<unsigned char>(value));
+			}
+
+			if (ignoreCase)
+				bytes = foldCase(bytes);
+
+			if (negated)
+				bytes.flip();
+
+			return true;
+		}
+
+		//skips a group ("i" is after the '('), false when it's malformed
+		bool skipGroup(std::string_view pattern, size_t& i) noexcept
+		{
+			size_t depth{ 1 };
+			bool inClass{ false };
+
+			while (i < pattern.size())
+			{
+				auto value = pattern[i++];
+				if (value == '\\')
+				{
+					i++;
+					continue;
+				}
+
+				if (inClass)
+				{
+					inClass = (value != ']');
+					continue;
+				}
+
+				if (value == '[')
+					inClass = true;
+				else if (value == '(')
+					depth++;
+				else if ((value == ')') && (--depth == 0))
+					return true;
+			}
+
+			return false;
+		}
+
+		//the atoms of an ecmascript pattern, nothing for the ones which aren't understood (e.g. with alternatives or backreferences)
+		std::optional<PatternAtoms> parsePattern(std::string_view pattern, bool ignoreCase)
+		{
+			PatternAtoms atoms;
+
+			auto breakRun = [&atoms]()
+			{
+				atoms.isFixed = false;
+				if (!atoms.runs.back().empty())
+					atoms.runs.emplace_back();
+			};
+
+			size_t i{ 0 };
+			while (i < pattern.size())
+			{
+				std::optional<Atom> atom;
+
+				auto value = pattern[i++];
+				switch (value)
+				{
+				case '|':
+				case ')':
+				case '*':
+				case '+':
+				case '?':
+				case '{':
+					return std::nullopt;
+				case '(':
+					if (!skipGroup(pattern, i))
+						return std::nullopt;
+					breakRun();
+					break;
+				case '^':
+				case '$':
+					breakRun();
+					break;
+				case '.':
+					atom = Atom{ ~(byteRange('\n', '\n') | byteRange('\r', '\r')) };
+					break;
+				case '[':
+				{
+					ByteSet bytes;
+					bool supported{ true };
+					if (!parseClass(pattern, i, ignoreCase, bytes, supported))
+						return std::nullopt;
+
+					if (supported)
+						atom = Atom{ bytes };
+					else
+						breakRun();
+					break;
+				}
+				case '\\':
+				{
+					if (i >= pattern.size())
+						return std::nullopt;
+
+					auto escape = pattern[i++];
+					if ((escape == 'b') || (escape == 'B'))
+					{
+						breakRun();
+						break;
+					}
+
+					if (auto escapeBytes = classEscape(escape); escapeBytes.has_value())
+					{
+						atom = Atom{ escapeBytes.value() };
+						break;
+					}
+
+					auto escapeValue = escapedByte(escape, pattern, i);
+					if (!escapeValue.has_value())
+						return std::nullopt;
+
+					value = escapeValue.value();
+					[[fallthrough]];
+				}
+				default:
+				{
+					//when the case is ignored, the bytes which aren't ascii are left to the locale of the regex
+					auto isAscii = (static_cast<unsigned char>(value) < 0x80);
+
+					atom = Atom{ byteRange(static_cast<unsigned char>(value), static_cast<unsigned char>(value)), (!ignoreCase || isAscii), value };
+					if (ignoreCase)
+						atom->bytes = foldCase(atom->bytes);
+
+					if (ignoreCase && !isAscii)
+						atoms.isFixed = false;
+					break;
+				}
+				}
+
+				size_t min, max;
+				if (!parseQuantifier(pattern, i, min, max))
+					return std::nullopt;
+
+				if (!atom.has_value() || ((min == 1) && (max == 1)))
+				{
+					if (atom.has_value())
+						atoms.runs.back().push_back(atom.value());
+					continue;
+				}
+
+				//a repeated atom is in the matches at least "min" times, but what follows it isn't at a fixed distance
+				if (min > 0)
+					atoms.runs.back().push_back(atom.value());
+
+				breakRun();
+			}
+
+			return atoms;
+		}
+	}
+
+	RegexSearcher::RegexSearcher(std::string_view pattern, std::regex::flag_type flags)
+		: m_regex{ std::string{ pattern }, flags }
+	{
+		//only the default grammar is understood
+		if ((flags & (std::regex::basic | std::regex::extended | std::regex::awk | std::regex::grep | std::regex::egrep)) != std::regex::flag_type{})
+			return;
+
+		auto ignoreCase = ((flags & std::regex::icase) == std::regex::icase);
+
+		auto atoms = parsePattern(pattern, ignoreCase);
+		if (!atoms.has_value())
+			return;
+
+		//the longest run of literals
+		size_t bestRun{ 0 }, bestStart{ 0 }, bestSize{ 0 };
+		for (size_t run = 0; run < atoms->runs.size(); run++)
+		{
+			const auto& runAtoms = atoms->runs[run];
+			for (size_t start = 0; start < runAtoms.size(); )
+			{
+				auto end = start;
+				while ((end < runAtoms.size()) && runAtoms[end].isLiteral)
+					end++;
+
+				if ((end - start) > bestSize)
+					std::tie(bestRun, bestStart, bestSize) = std::make_tuple(run, start, end - start);
+
+				start = end + 1;
+			}
+		}
+
+		if (bestSize >= MinLiteralSize)
+		{
+			std::string literal;
+			for (size_t i = bestStart; i < (bestStart + bestSize); i++)
+				literal.push_back(atoms->runs[bestRun][i].value);
+
+			m_literal.emplace(literal, ignoreCase);
+			m_literalOffset = bestStart;
+		}
+
+		if (atoms->isFixed && !atoms->runs[0].empty())
+		{
+			for (const auto& atom : atoms->runs[0])
+				m_fixedBytes.push_back(atom.bytes);
+		}
+	}
+
+	const char* RegexSearcher::operator()(const char* dataStart, const char* dataEnd) const
+	{
+		if (!m_fixedBytes.empty())
+			return findFixed(dataStart, dataEnd);
+
+		if (!mayMatch(dataStart, dataEnd))
+			return dataEnd;
+
+		std::cmatch matches;
+		if (!std::regex_search(dataStart, dataEnd, matches, m_regex))
+			return dataEnd;
+
+		return matches[0].first;
+	}
+
+	bool RegexSearcher::search(const char* dataStart, const char* dataEnd) const
+	{
+		if (!m_fixedBytes.empty())
+			return (findFixed(dataStart, dataEnd) != dataEnd);
+
+		return (mayMatch(dataStart, dataEnd) && std::regex_search(dataStart, dataEnd, m_regex));
+	}
+
+	bool RegexSearcher::search(const char* dataStart, const char* dataEnd, std::cmatch& matches) const
+	{
+		return (mayMatch(dataStart, dataEnd) && std::regex_search(dataStart, dataEnd, matches, m_regex));
+	}
+
+	bool RegexSearcher::match(const char* dataStart, const char* dataEnd) const
+	{
+		return (mayMatch(dataStart, dataEnd) && std::regex_match(dataStart, dataEnd, m_regex));
+	}
+
+	const char* RegexSearcher::findFixed(const char* dataStart, const char* dataEnd) const noexcept
+	{
+		auto matchSize = m_fixedBytes.size();
+		if (static_cast<size_t>(dataEnd - dataStart) < matchSize)
+			return dataEnd;
+
+		auto matchesAt = [this, matchSize](const char* candidate)
+		{
+			for (size_t i = 0; i < matchSize; i++)
+			{
+				if (!m_fixedBytes[i][static_cast<unsigned char>(candidate[i])])
+					return false;
+			}
+
+			return true;
+		};
+
+		if (!m_literal.has_value())
+		{
+			for (auto candidate = dataStart; candidate <= (dataEnd - matchSize); candidate++)
+			{
+				if (matchesAt(candidate))
+					return candidate;
+			}
+
+			return dataEnd;
+		}
+
+		//the literal is at the same offset in all the matches, so only its positions are candidates
+		for (auto walker = dataStart + m_literalOffset; walker < dataEnd; )
+		{
+			auto literalPtr = m_literal.value()(walker, dataEnd);
+			if (literalPtr >= dataEnd)
+				break;
+
+			auto candidate = literalPtr - m_literalOffset;
+			if ((static_cast<size_t>(dataEnd - candidate) >= matchSize) && matchesAt(candidate))
+				return candidate;
+
+			walker = literalPtr + 1;
+		}
+
+		return dataEnd;
+	}
+
+	bool RegexSearcher::mayMatch(const char* dataStart, const char* dataEnd) const
+	{
+		if (!m_fixedBytes.empty())
+			return (findFixed(dataStart, dataEnd) != dataEnd);
+
+		if (m_literal.has_value())
+			return (m_literal.value()(dataStart, dataEnd) != dataEnd);
+
+		return true;
+	}
+}
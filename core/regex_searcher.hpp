@@ -0,0 +1,54 @@
+#ifndef LA_REGEX_SEARCHER_HPP
+#define LA_REGEX_SEARCHER_HPP
+
+#include "text_searcher.hpp"
+
+#include <regex>
+#include <bitset>
+#include <vector>
+#include <optional>
+#include <string_view>
+
+namespace la
+{
+	//a regex which rejects the data without the literal all its matches contain (e.g. "User-Agent: ") before running it
+	//patterns of a fixed size (literals, classes and '.', without quantifiers, groups or anchors) don't run the regex to find a match
+	class RegexSearcher final
+	{
+	public:
+		RegexSearcher(std::string_view pattern, std::regex::flag_type flags = std::regex::ECMAScript); //throws "std::regex_error" as "std::regex" does
+
+		//the start of the first match ("dataEnd" when there is none)
+		const char* operator()(const char* dataStart, const char* dataEnd) const;
+
+		bool search(const char* dataStart, const char* dataEnd) const;
+		bool search(const char* dataStart, const char* dataEnd, std::cmatch& matches) const;
+		bool match(const char* dataStart, const char* dataEnd) const;
+
+		//the text all the matches have (empty when there is none long enough, in lowercase when the case is ignored)
+		std::string_view literal() const noexcept
+		{
+			return m_literal.has_value() ? m_literal.value().query() : std::string_view{};
+		}
+
+		//the size of all the matches of a fixed size pattern (0 for the others)
+		size_t fixedSize() const noexcept
+		{
+			return m_fixedBytes.size();
+		}
+
+	private:
+		const char* findFixed(const char* dataStart, const char* dataEnd) const noexcept;
+		bool mayMatch(const char* dataStart, const char* dataEnd) const;
+
+	private:
+		std::regex m_regex;
+
+		std::optional<TextSearcher> m_literal;
+		size_t m_literalOffset{ 0 }; //in the matches of a fixed size pattern
+
+		std::vector<std::bitset<256>> m_fixedBytes; //the bytes allowed at each position of the matches of a fixed size pattern
+	};
+}
+
+#endif
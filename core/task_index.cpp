@@ -0,0 +1,135 @@
+#include "task_index.hpp"
+
+#include "line_events.hpp"
+#include "lines_tools.hpp"
+
+#include <array>
+#include <charconv>
+#include <algorithm>
+#include <string_view>
+
+namespace la
+{
+	namespace
+	{
+		struct EventMsg
+		{
+			std::string_view msg;
+			TaskIndex::EventType type;
+			std::string_view paramsNext; //what follows the "id=X;" which starts the params
+		};
+
+		constexpr std::array<EventMsg, 14> EventMsgs{ {
+			{ "task scheduled", TaskIndex::EventType::Scheduled, " name=" },
+			{ "task executing", TaskIndex::EventType::Executing, " name=" },
+			{ "task finishing", TaskIndex::EventType::Finishing, " name=" },
+			{ "task waiting (sync)", TaskIndex::EventType::WaitingSync, " waiting for=" },
+			{ "task waiting (time)", TaskIndex::EventType::WaitingTime, " ms=" },
+			{ "task waiting (task)", TaskIndex::EventType::WaitingTask, " waiting for=" },
+			{ "task moving on (sync)", TaskIndex::EventType::MovingOnSync, " waited for=" },
+			{ "task moving on (task)", TaskIndex::EventType::MovingOnTask, " waited for=" },
+			{ "task cancelled", TaskIndex::EventType::Cancelled, "" },
+			{ "scheduler canceled a task that didn't have support to be canceled", TaskIndex::EventType::CanceledUnsupported, " name=" },
+			{ "canceling task because task is already running", TaskIndex::EventType::CancelingRunning, " name=" },
+			{ "ignoring task remove because task is already running", TaskIndex::EventType::IgnoringRemoveRunning, " name=" },
+			{ "removed task", TaskIndex::EventType::Removed, " name=" },
+			{ "task finished", TaskIndex::EventType::Finished, " name=" }
+		} };
+
+		//the task id of params which start with "id=X;" followed by "paramsNext"
+		std::optional<int64_t> parseTaskId(std::string_view params, std::string_view paramsNext)
+		{
+			constexpr std::string_view ParamId{ "id=" };
+			if (params.substr(0, ParamId.size()) != ParamId)
+				return std::nullopt;
+
+			int64_t taskId;
+			auto [p, ec] = std::from_chars(params.data() + ParamId.size(), params.data() + params.size(), taskId);
+			if ((ec != std::errc()) || (p == (params.data() + params.size())) || (*p != ';'))
+				return std::nullopt;
+
+			auto rest = params.substr(static_cast<size_t>(p + 1 - params.data()));
+			if (rest.substr(0, paramsNext.size()) != paramsNext)
+				return std::nullopt;
+
+			return taskId;
+		}
+	}
+
+	const std::vector<TaskIndex::Event>& TaskIndex::taskEvents(int64_t taskId) const
+	{
+		static const std::vector<Event> NoEvents;
+
+		auto itTask = m_tasks.find(taskId);
+		return (itTask != m_tasks.end()) ? itTask->second : NoEvents;
+	}
+
+	std::optional<TaskIndex::Event> TaskIndex::findFirst(int64_t taskId, EventType type, size_t lineIndexStart, size_t lineIndexEnd) const
+	{
+		return LineEvents::findFirst(taskEvents(taskId), type, lineIndexStart, lineIndexEnd);
+	}
+
+	std::optional<TaskIndex::Event> TaskIndex::findLast(int64_t taskId, EventType type, size_t lineIndexEnd) const
+	{
+		return LineEvents::findLast(taskEvents(taskId), type, lineIndexEnd);
+	}
+
+	std::optional<TaskIndex::Execution> TaskIndex::lastExecution(int32_t threadId, size_t lineIndexEnd) const
+	{
+		auto itThread = m_threadsExecutions.find(threadId);
+		if (itThread == m_threadsExecutions.end())
+			return std::nullopt;
+
+		const auto& executions = itThread->second;
+
+		auto itExecution = LineEvents::lowerBound(executions, lineIndexEnd);
+		if (itExecution == executions.begin())
+			return std::nullopt;
+
+		return *(itExecution - 1);
+	}
+
+	void TaskIndex::truncate(size_t numLines)
+	{
+		if (numLines >= m_numLines)
+			return;
+
+		LineEvents::truncate(m_tasks, numLines);
+		LineEvents::truncate(m_threadsExecutions, numLines);
+
+		m_numLines = numLines;
+	}
+
+	void TaskIndex::extend(const LinesTools& linesTools)
+	{
+		auto numLines = linesTools.lines().size();
+		if (m_numLines >= numLines)
+			return;
+
+		LinesTools::FilterCollection filter{
+			LinesTools::FilterParam<LinesTools::FilterType::Tag, std::string_view>("COMLib.Scheduler") };
+
+		auto& threadIds = linesTools.threadIds();
+
+		linesTools.windowIterate({ m_numLines, numLines }, filter, [this, &threadIds](size_t, LogLine line, size_t lineIndex)
+		{
+			auto msg = line.getSectionMsg();
+
+			auto itEventMsg = std::find_if(EventMsgs.begin(), EventMsgs.end(), [msg](const EventMsg& eventMsg) { return (eventMsg.msg == msg); });
+			if (itEventMsg == EventMsgs.end())
+				return true;
+
+			auto taskId = parseTaskId(line.getSectionParams(), itEventMsg->paramsNext);
+			if (!taskId.has_value())
+				return true;
+
+			m_tasks[*taskId].push_back({ lineIndex, itEventMsg->type, threadIds[lineIndex] });
+			if (itEventMsg->type == EventType::Executing)
+				m_threadsExecutions[threadIds[lineIndex]].push_back({ lineIndex, *taskId });
+
+			return true;
+		});
+
+		m_numLines = numLines;
+	}
+}
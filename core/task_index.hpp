@@ -0,0 +1,81 @@
+#ifndef LA_TASK_INDEX_HPP
+#define LA_TASK_INDEX_HPP
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace la
+{
+	class LinesTools;
+
+	//the lifecycle of the COMLib tasks (the "COMLib.Scheduler" lines with "id=X; ..." params), found in a single pass over the lines
+	//task ids are reused by other executions of the app, so the events of an id are usually looked up in a range of lines
+	class TaskIndex final
+	{
+	public:
+		enum class EventType : uint8_t
+		{
+			Scheduled,
+			Executing,
+			Finishing,
+			WaitingSync,
+			WaitingTime,
+			WaitingTask,
+			MovingOnSync,
+			MovingOnTask,
+			Cancelled,
+			CanceledUnsupported, //"scheduler canceled a task that didn't have support to be canceled"
+			CancelingRunning, //"canceling task because task is already running"
+			IgnoringRemoveRunning, //"ignoring task remove because task is already running"
+			Removed,
+			Finished
+		};
+
+		struct Event
+		{
+			size_t lineIndex;
+			EventType type;
+			int32_t threadId;
+		};
+
+		struct Execution
+		{
+			size_t lineIndex;
+			int64_t taskId;
+		};
+
+	public:
+		//the lines [0, numLines()) are indexed
+		size_t numLines() const noexcept
+		{
+			return m_numLines;
+		}
+
+		//the events of a task, in order (empty when it has none)
+		const std::vector<Event>& taskEvents(int64_t taskId) const;
+
+		//the first event of a task with the type, in [lineIndexStart, lineIndexEnd)
+		std::optional<Event> findFirst(int64_t taskId, EventType type, size_t lineIndexStart, size_t lineIndexEnd) const;
+
+		//the last event of a task with the type, in [0, lineIndexEnd)
+		std::optional<Event> findLast(int64_t taskId, EventType type, size_t lineIndexEnd) const;
+
+		//the last "task executing" of a thread, in [0, lineIndexEnd) (the task the thread is running, if it didn't finish)
+		std::optional<Execution> lastExecution(int32_t threadId, size_t lineIndexEnd) const;
+
+		//the events from "numLines" on are removed
+		void truncate(size_t numLines);
+
+		//indexes the lines after the ones already indexed
+		void extend(const LinesTools& linesTools);
+
+	private:
+		size_t m_numLines{ 0 };
+		std::unordered_map<int64_t, std::vector<Event>> m_tasks;
+		std::unordered_map<int32_t, std::vector<Execution>> m_threadsExecutions;
+	};
+}
+
+#endif
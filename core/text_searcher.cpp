@@ -0,0 +1,228 @@
+#include "text_searcher.hpp"
+#include "lines_scanner.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define LA_TEXT_SEARCHER_X86
+	#include <immintrin.h>
+#endif
+
+#if defined(LA_TEXT_SEARCHER_X86) && !defined(_MSC_VER)
+	#define LA_TEXT_SEARCHER_TARGET(x) __attribute__((target(x)))
+#else
+	#define LA_TEXT_SEARCHER_TARGET(x)
+#endif
+
+namespace la
+{
+	namespace
+	{
+		constexpr char CaseMask{ 0x20 }; //the bit which differs between an ascii uppercase letter and its lowercase
+
+		using FindFunc = const char*(*)(const char* dataStart, const char* dataEnd, const char* query, const char* caseMasks, size_t querySize);
+
+		inline unsigned int countTrailingZeros(uint32_t bits) noexcept
+		{
+#if defined(_MSC_VER)
+			unsigned long index{ 0 };
+			_BitScanForward(&index, bits);
+			return static_cast<unsigned int>(index);
+#else
+			return static_cast<unsigned int>(__builtin_ctz(bits));
+#endif
+		}
+
+		inline bool matchesAt(const char* data, const char* query, const char* caseMasks, size_t querySize) noexcept
+		{
+			for (size_t i = 0; i < querySize; i++)
+			{
+				if (static_cast<char>(data[i] | caseMasks[i]) != query[i])
+					return false;
+			}
+
+			return true;
+		}
+
+		const char* findScalar(const char* dataStart, const char* dataEnd, const char* query, const char* caseMasks, size_t querySize) noexcept
+		{
+			if (querySize > static_cast<size_t>(dataEnd - dataStart))
+				return dataEnd;
+
+			auto walkerEnd = dataEnd - querySize;
+			for (auto walker = dataStart; walker <= walkerEnd; walker++)
+			{
+				if ((static_cast<char>(walker[0] | caseMasks[0]) == query[0]) && matchesAt(walker + 1, query + 1, caseMasks + 1, querySize - 1))
+					return walker;
+			}
+
+			return dataEnd;
+		}
+
+#if defined(LA_TEXT_SEARCHER_X86)
+		struct SSE2Block
+		{
+			static constexpr size_t Size{ 16 };
+
+			//a bit per position where both the first and the last byte of the query match
+			LA_TEXT_SEARCHER_TARGET("sse2") static uint32_t candidates(const char* first, const char* last, char firstChar, char firstMask, char lastChar, char lastMask) noexcept
+			{
+				auto firstChars = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), _mm_set1_epi8(firstMask));
+				auto lastChars = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(last)), _mm_set1_epi8(lastMask));
+				auto found = _mm_and_si128(_mm_cmpeq_epi8(firstChars, _mm_set1_epi8(firstChar)), _mm_cmpeq_epi8(lastChars, _mm_set1_epi8(lastChar)));
+
+				return static_cast<uint32_t>(_mm_movemask_epi8(found));
+			}
+		};
+
+		struct AVX2Block
+		{
+			static constexpr size_t Size{ 32 };
+
+			LA_TEXT_SEARCHER_TARGET("avx2") static uint32_t candidates(const char* first, const char* last, char firstChar, char firstMask, char lastChar, char lastMask) noexcept
+			{
+				auto firstChars = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), _mm256_set1_epi8(firstMask));
+				auto lastChars = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(last)), _mm256_set1_epi8(lastMask));
+				auto found = _mm256_and_si256(_mm256_cmpeq_epi8(firstChars, _mm256_set1_epi8(firstChar)), _mm256_cmpeq_epi8(lastChars, _mm256_set1_epi8(lastChar)));
+
+				return static_cast<uint32_t>(_mm256_movemask_epi8(found));
+			}
+		};
+#endif
+
+		template<typename TBlock>
+		inline const char* findText(const char* dataStart, const char* dataEnd, const char* query, const char* caseMasks, size_t querySize) noexcept
+		{
+			if (querySize > static_cast<size_t>(dataEnd - dataStart))
+				return dataEnd;
+
+			//the blocks at the first and at the last byte of the query are compared together, the bytes between them only for the candidates
+			auto lastOffset = querySize - 1;
+			auto middleSize = (querySize > 2) ? (querySize - 2) : 0;
+
+			auto walker = dataStart;
+			while (static_cast<size_t>(dataEnd - walker) >= (lastOffset + TBlock::Size))
+			{
+				auto bits = TBlock::candidates(walker, walker + lastOffset, query[0], caseMasks[0], query[lastOffset], caseMasks[lastOffset]);
+				while (bits != 0)
+				{
+					auto candidate = walker + countTrailingZeros(bits);
+					if (matchesAt(candidate + 1, query + 1, caseMasks + 1, middleSize))
+						return candidate;
+
+					bits &= (bits - 1);
+				}
+
+				walker += TBlock::Size;
+			}
+
+			return findScalar(walker, dataEnd, query, caseMasks, querySize);
+		}
+
+#if defined(LA_TEXT_SEARCHER_X86)
+		LA_TEXT_SEARCHER_TARGET("sse2") const char* findTextSSE2(const char* dataStart, const char* dataEnd, const char* query, const char* caseMasks, size_t querySize) noexcept
+		{
+			return findText<SSE2Block>(dataStart, dataEnd, query, caseMasks, querySize);
+		}
+
+		LA_TEXT_SEARCHER_TARGET("avx2") const char* findTextAVX2(const char* dataStart, const char* dataEnd, const char* query, const char* caseMasks, size_t querySize) noexcept
+		{
+			return findText<AVX2Block>(dataStart, dataEnd, query, caseMasks, querySize);
+		}
+#endif
+
+		FindFunc selectFindFunc() noexcept
+		{
+			//the cpu level is the one detected for the line breaks scanner
+			switch (LinesScanner::level())
+			{
+#if defined(LA_TEXT_SEARCHER_X86)
+			case LinesScanner::Level::AVX2:
+				return findTextAVX2;
+			case LinesScanner::Level::SSE2:
+				return findTextSSE2;
+#endif
+			default:
+				return findScalar;
+			}
+		}
+
+		FindFunc findFunc() noexcept
+		{
+			static const auto func{ selectFindFunc() };
+			return func;
+		}
+
+		//memchr jumps over the data faster than the kernel compares it, but only when the first byte of the query is rare in the data
+		const char* findRareFirst(const char* dataStart, const char* dataEnd, const char* query, size_t querySize) noexcept
+		{
+			if (querySize > static_cast<size_t>(dataEnd - dataStart))
+				return dataEnd;
+
+			auto walker = dataStart;
+			auto walkerEnd = dataEnd - querySize + 1; //the last position where the query fits, plus one
+			while (walker < walkerEnd)
+			{
+				auto candidate = static_cast<const char*>(std::memchr(walker, query[0], static_cast<size_t>(walkerEnd - walker)));
+				if (candidate == nullptr)
+					return dataEnd;
+
+				if (std::memcmp(candidate + 1, query + 1, querySize - 1) == 0)
+					return candidate;
+
+				walker = candidate + 1;
+			}
+
+			return dataEnd;
+		}
+
+		//the bytes which are frequent in the logs: letters (but the rarest ones), digits, spaces and the usual separators of the lines and params
+		bool isFrequentByte(char value) noexcept
+		{
+			constexpr std::string_view RareLetters{ "jqxzJQXZ" };
+			constexpr std::string_view FrequentSeparators{ " \t.,:;|=-_/()[]'\"" };
+
+			auto isLetter = (((value | CaseMask) >= 'a') && ((value | CaseMask) <= 'z'));
+			if (isLetter)
+				return (RareLetters.find(value) == std::string_view::npos);
+
+			return (((value >= '0') && (value <= '9')) || (FrequentSeparators.find(value) != std::string_view::npos));
+		}
+	}
+
+	TextSearcher::TextSearcher(std::string_view query, bool ignoreCase)
+		: m_query{ query }
+		, m_caseMasks(query.size(), '\0')
+		, m_rareFirst{ !ignoreCase && !query.empty() && !isFrequentByte(query[0]) }
+	{
+		if (!ignoreCase)
+			return;
+
+		for (size_t i = 0; i < m_query.size(); i++)
+		{
+			auto lowerChar = static_cast<char>(m_query[i] | CaseMask);
+			if ((lowerChar < 'a') || (lowerChar > 'z'))
+				continue;
+
+			m_query[i] = lowerChar;
+			m_caseMasks[i] = CaseMask;
+		}
+	}
+
+	const char* TextSearcher::operator()(const char* dataStart, const char* dataEnd) const noexcept
+	{
+		if (m_query.empty())
+			return dataStart;
+
+		if (m_rareFirst)
+			return findRareFirst(dataStart, dataEnd, m_query.data(), m_query.size());
+
+		return findFunc()(dataStart, dataEnd, m_query.data(), m_caseMasks.data(), m_query.size());
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef LA_TEXT_SEARCHER_HPP
+#define LA_TEXT_SEARCHER_HPP
+
+#include <string>
+#include <string_view>
+
+namespace la
+{
+	class TextSearcher final
+	{
+	public:
+		TextSearcher(std::string_view query, bool ignoreCase);
+
+		//the first match in the data ("dataEnd" when there is none), the case is only ignored for ascii letters
+		const char* operator()(const char* dataStart, const char* dataEnd) const noexcept;
+
+		size_t size() const noexcept
+		{
+			return m_query.size();
+		}
+
+		std::string_view query() const noexcept
+		{
+			return m_query;
+		}
+
+	private:
+		std::string m_query; //lowercase when the case is ignored
+		std::string m_caseMasks; //0x20 on the letters when the case is ignored (a byte matches if "(byte | mask) == query byte")
+		bool m_rareFirst; //with the case, a query starting with a rare byte is found with memchr instead of the kernel
+	};
+}
+
+#endif
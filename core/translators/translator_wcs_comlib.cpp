@@ -23,10 +23,11 @@ namespace la
             }
             else
             {
-                assert(line.sectionParams.offset < translationCtx.output.size());
+                auto paramsOffset = line.sectionOffset(LogLine::SectionType::Params);
+                assert(paramsOffset < translationCtx.output.size());
 
-                const char* start = translationCtx.output.data() + line.sectionParams.offset;
-                const char* end = start + translationCtx.output.size() - line.sectionParams.offset;
+                const char* start = translationCtx.output.data() + paramsOffset;
+                const char* end = start + translationCtx.output.size() - paramsOffset;
                 if (!std::regex_search(start, end, match, filter) || (match.size() != 2))
                     return false;
             }
@@ -51,7 +52,7 @@ namespace la
 
             if (translationCtx.output.empty())
             {
-                translationCtx.output.append(line.data.start, line.data.start + line.sectionParams.offset);
+                translationCtx.output.append(line.dataStart, line.dataStart + line.sectionOffset(LogLine::SectionType::Params));
 
                 translationCtx.output.append(match.prefix().first, match.prefix().second);
                 translationCtx.output
@@ -63,7 +64,7 @@ namespace la
             else
             {
                 translationCtx.auxiliary.clear();
-                translationCtx.auxiliary.append(line.data.start, line.data.start + line.sectionParams.offset);
+                translationCtx.auxiliary.append(line.dataStart, line.dataStart + line.sectionOffset(LogLine::SectionType::Params));
 
                 translationCtx.auxiliary.append(match.prefix().first, match.prefix().second);
                 translationCtx.auxiliary
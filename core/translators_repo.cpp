@@ -89,11 +89,11 @@ namespace la
 		}
 	}
 
-	bool TranslatorsRepo::translate(Type type, Format format, FlavorsRepo::Type flavor, LogLine line, TranslationCtx& translationCtx)
+	bool TranslatorsRepo::translate(Type type, Format format, FlavorsRepo::Type flavor, LogLine line, const LogLineHeader& header, TranslationCtx& translationCtx)
 	{
 		assert(translationCtx.output.empty());
 
-		if (line.data.end <= line.data.start)
+		if (line.dataSize == 0)
 			return false;
 
 		if (type == Type::Raw)
@@ -103,7 +103,7 @@ namespace la
 			switch (format)
 			{
 			case Format::Line:
-				translationCtx.output.append(line.data.start, line.data.end);
+				translationCtx.output.append(line.dataStart, line.dataEnd());
 				return true;
 			case Format::JSONFull:
 			case Format::JSONSingleParams:
@@ -111,9 +111,9 @@ namespace la
 				nlohmann::json jLine;
 
 				jLine["id"] = line.id;
-				jLine["timestamp"] = line.timestamp;
-				jLine["threadId"] = line.threadId;
-				jLine["level"] = line.level;
+				jLine["timestamp"] = header.timestamp;
+				jLine["threadId"] = header.threadId;
+				jLine["level"] = header.level;
 
 				jLine["tag"] = line.getSectionTag();
 				jLine["method"] = line.getSectionMethod();
@@ -164,23 +164,24 @@ namespace la
 			case Format::Line:
 
 				if (translationCtx.output.empty())
-					return TranslatorsRepo::translate(Type::Raw, format, flavor, line, translationCtx); //default to raw (no translation)
+					return TranslatorsRepo::translate(Type::Raw, format, flavor, line, header, translationCtx); //default to raw (no translation)
 				return true;
 
 			case Format::JSONFull:
 			case Format::JSONSingleParams:
 			{
 				if (translationCtx.output.empty())
-					return TranslatorsRepo::translate(Type::Raw, format, flavor, line, translationCtx); //default to raw (no translation)
+					return TranslatorsRepo::translate(Type::Raw, format, flavor, line, header, translationCtx); //default to raw (no translation)
 
 				LogLine newLine;
+				LogLineHeader newHeader;
 				auto currentTranslation = translationCtx.output; //newLine will point to this string
 
-				if (FlavorsRepo::processLineData(flavor, currentTranslation, newLine))
+				if (FlavorsRepo::processLineData(flavor, currentTranslation, newLine, newHeader))
 				{
 					translationCtx.output.clear();
 					translationCtx.auxiliary.clear();
-					return TranslatorsRepo::translate(Type::Raw, format, flavor, newLine, translationCtx);
+					return TranslatorsRepo::translate(Type::Raw, format, flavor, newLine, newHeader, translationCtx);
 				}
 
 				break;
@@ -36,7 +36,8 @@ namespace la
 		};
 
 	public:
-		static bool translate(Type type, Format format, FlavorsRepo::Type flavor, LogLine line, TranslationCtx& translationCtx);
+		//the header of the line is only needed by the JSON formats
+		static bool translate(Type type, Format format, FlavorsRepo::Type flavor, LogLine line, const LogLineHeader& header, TranslationCtx& translationCtx);
 	};
 }
 
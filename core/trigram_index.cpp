@@ -0,0 +1,335 @@
+#include "trigram_index.hpp"
+
+#include "utils.hpp"
+
+#include <limits>
+#include <cstring>
+#include <ostream>
+#include <algorithm>
+#include <type_traits>
+
+namespace la
+{
+	namespace
+	{
+		constexpr uint32_t FormatVersion{ 1 };
+
+		constexpr size_t TaskBlocks{ 64 }; //blocks whose trigrams are found by one worker (with the same set of seen trigrams)
+		constexpr size_t BatchBlocks{ 1024 }; //blocks whose trigrams are kept before being added to the postings
+
+		constexpr size_t NumTrigrams{ size_t{ 1 } << 24 };
+
+		//the rarest trigrams of a text already reject almost all the blocks the others would (and decoding the common ones costs more than searching those few blocks)
+		constexpr size_t MaxIntersectedPostings{ 4 };
+
+		struct StoredHeader
+		{
+			uint32_t version;
+			uint32_t blockSize;
+			uint64_t numLines;
+			uint64_t numPostings;
+		};
+
+		struct StoredPosting
+		{
+			uint32_t trigram;
+			uint32_t lastBlock;
+			uint32_t numBlocks;
+			uint32_t numBytes;
+		};
+
+		static_assert(std::is_trivial_v<StoredHeader> && std::is_trivial_v<StoredPosting>);
+
+		inline uint8_t foldCase(uint8_t c) noexcept
+		{
+			return ((c >= 'A') && (c <= 'Z')) ? static_cast<uint8_t>(c | 0x20) : c;
+		}
+
+		//calls "cb" with each trigram of the data, in order
+		template<class TCb>
+		inline void iterateTrigrams(const char* dataStart, const char* dataEnd, TCb&& cb)
+		{
+			if ((dataEnd - dataStart) < 3)
+				return;
+
+			auto walker = reinterpret_cast<const uint8_t*>(dataStart);
+			auto walkerEnd = reinterpret_cast<const uint8_t*>(dataEnd);
+
+			uint32_t trigram = (static_cast<uint32_t>(foldCase(walker[0])) << 8) | foldCase(walker[1]);
+			for (walker += 2; walker < walkerEnd; walker++)
+			{
+				trigram = ((trigram << 8) | foldCase(*walker)) & static_cast<uint32_t>(NumTrigrams - 1);
+				cb(trigram);
+			}
+		}
+
+		//the distinct trigrams of the lines of a block ("seen" has a bit per trigram, and is cleared before returning)
+		void blockTrigrams(const std::vector<LogLine>& lines, size_t block, std::vector<uint64_t>& seen, std::vector<uint32_t>& trigrams)
+		{
+			auto lineIndex = block * TrigramIndex::BlockSize;
+			auto lineIndexEnd = std::min(lineIndex + TrigramIndex::BlockSize, lines.size());
+
+			for (; lineIndex < lineIndexEnd; lineIndex++)
+			{
+				iterateTrigrams(lines[lineIndex].dataStart, lines[lineIndex].dataEnd(), [&seen, &trigrams](uint32_t trigram)
+				{
+					auto& word = seen[trigram / 64];
+					auto bit = uint64_t{ 1 } << (trigram % 64);
+					if ((word & bit) != 0)
+						return;
+
+					word |= bit;
+					trigrams.push_back(trigram);
+				});
+			}
+
+			for (auto trigram : trigrams)
+				seen[trigram / 64] = 0;
+		}
+	}
+
+	void TrigramIndex::Posting::push(uint32_t block)
+	{
+		auto delta = deltas.empty() ? block : (block - lastBlock);
+		while (delta >= 0x80)
+		{
+			deltas.push_back(static_cast<uint8_t>(delta | 0x80));
+			delta >>= 7;
+		}
+		deltas.push_back(static_cast<uint8_t>(delta));
+
+		lastBlock = block;
+		numBlocks++;
+	}
+
+	void TrigramIndex::Posting::pop()
+	{
+		//the bytes before the last one of the last delta all have the high bit set
+		auto deltaStart = deltas.size() - 1;
+		while ((deltaStart > 0) && ((deltas[deltaStart - 1] & 0x80) != 0))
+			deltaStart--;
+
+		uint32_t delta{ 0 };
+		for (auto i = deltas.size(); i > deltaStart; i--)
+			delta = (delta << 7) | (deltas[i - 1] & 0x7F);
+
+		deltas.resize(deltaStart);
+		lastBlock = deltas.empty() ? 0 : (lastBlock - delta);
+		numBlocks--;
+	}
+
+	void TrigramIndex::Posting::decode(std::vector<uint32_t>& blocks, uint32_t blockStart, uint32_t blockEnd) const
+	{
+		blocks.clear();
+
+		uint32_t block{ 0 };
+		uint32_t delta{ 0 };
+		uint32_t shift{ 0 };
+		for (auto byte : deltas)
+		{
+			if (shift < 32)
+				delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			shift += 7;
+			if ((byte & 0x80) != 0)
+				continue;
+
+			block += delta;
+			if (block >= blockEnd)
+				break;
+			if (block >= blockStart)
+				blocks.push_back(block);
+
+			delta = 0;
+			shift = 0;
+		}
+	}
+
+	std::optional<std::vector<uint32_t>> TrigramIndex::candidateBlocks(std::string_view text, uint32_t blockStart, uint32_t blockEnd) const
+	{
+		if (text.size() < 3)
+			return std::nullopt;
+
+		std::vector<const Posting*> postings;
+		bool missing{ false };
+
+		iterateTrigrams(text.data(), text.data() + text.size(), [this, &postings, &missing](uint32_t trigram)
+		{
+			auto itPosting = m_postings.find(trigram);
+			if (itPosting == m_postings.end())
+				missing = true;
+			else if (std::find(postings.begin(), postings.end(), &itPosting->second) == postings.end())
+				postings.push_back(&itPosting->second);
+		});
+
+		std::vector<uint32_t> blocks;
+		if (missing)
+			return blocks;
+
+		//the rarest trigrams first, so the candidates are few from the start
+		std::sort(postings.begin(), postings.end(), [](const Posting* a, const Posting* b) { return (a->numBlocks < b->numBlocks); });
+		if (postings.size() > MaxIntersectedPostings)
+			postings.resize(MaxIntersectedPostings);
+
+		postings.front()->decode(blocks, blockStart, blockEnd);
+
+		std::vector<uint32_t> postingBlocks;
+		for (size_t i = 1; (i < postings.size()) && !blocks.empty(); i++)
+		{
+			postings[i]->decode(postingBlocks, blocks.front(), blocks.back() + 1);
+			blocks.erase(std::set_intersection(blocks.begin(), blocks.end(), postingBlocks.begin(), postingBlocks.end(), blocks.begin()), blocks.end());
+		}
+
+		return blocks;
+	}
+
+	void TrigramIndex::truncate(size_t numLines)
+	{
+		if (numLines >= m_numLines)
+			return;
+
+		auto firstRemovedBlock = static_cast<uint32_t>(numLines / BlockSize);
+		for (auto itPosting = m_postings.begin(); itPosting != m_postings.end(); )
+		{
+			auto& posting = itPosting->second;
+			while ((posting.numBlocks > 0) && (posting.lastBlock >= firstRemovedBlock))
+				posting.pop();
+
+			if (posting.numBlocks == 0)
+				itPosting = m_postings.erase(itPosting);
+			else
+				itPosting++;
+		}
+
+		m_numLines = firstRemovedBlock * BlockSize;
+	}
+
+	bool TrigramIndex::extend(const std::vector<LogLine>& lines, const std::atomic<bool>& cancel)
+	{
+		//a partial last block is indexed again, with all its lines
+		truncate(std::min((m_numLines / BlockSize) * BlockSize, lines.size()));
+
+		auto numBlocks = (lines.size() + BlockSize - 1) / BlockSize;
+		if (numBlocks > std::numeric_limits<uint32_t>::max())
+			return false;
+
+		//the trigrams of the blocks of a batch are found in parallel, then added to the postings in order
+		std::vector<std::vector<uint32_t>> blocksTrigrams;
+		for (auto batchStart = m_numLines / BlockSize; batchStart < numBlocks; batchStart += BatchBlocks)
+		{
+			if (cancel)
+				return false;
+
+			auto batchEnd = std::min(batchStart + BatchBlocks, numBlocks);
+
+			blocksTrigrams.resize(batchEnd - batchStart);
+			utils::Parallel::forEach((blocksTrigrams.size() + TaskBlocks - 1) / TaskBlocks, [&lines, &blocksTrigrams, batchStart, batchEnd](size_t task)
+			{
+				std::vector<uint64_t> seen(NumTrigrams / 64, 0);
+
+				auto taskEnd = std::min(batchStart + ((task + 1) * TaskBlocks), batchEnd);
+				for (auto block = batchStart + (task * TaskBlocks); block < taskEnd; block++)
+				{
+					auto& trigrams = blocksTrigrams[block - batchStart];
+					trigrams.clear();
+					blockTrigrams(lines, block, seen, trigrams);
+				}
+			});
+
+			for (auto block = batchStart; block < batchEnd; block++)
+			{
+				for (auto trigram : blocksTrigrams[block - batchStart])
+					m_postings[trigram].push(static_cast<uint32_t>(block));
+			}
+
+			m_numLines = std::min(batchEnd * BlockSize, lines.size());
+		}
+
+		m_numLines = lines.size();
+		return true;
+	}
+
+	bool TrigramIndex::load(const char* data, size_t size)
+	{
+		auto walker = data;
+		auto walkerEnd = data + size;
+
+		auto read = [&walker, walkerEnd](void* out, size_t size)
+		{
+			if (static_cast<size_t>(walkerEnd - walker) < size)
+				return false;
+
+			std::memcpy(out, walker, size);
+			walker += size;
+			return true;
+		};
+
+		StoredHeader header;
+		if (!read(&header, sizeof(StoredHeader)))
+			return false;
+		if ((header.version != FormatVersion) || (header.blockSize != BlockSize))
+			return false;
+
+		m_numLines = static_cast<size_t>(header.numLines);
+		m_postings.clear();
+		m_postings.reserve(static_cast<size_t>(std::min<uint64_t>(header.numPostings, NumTrigrams)));
+
+		//the postings are decoded to check them (blocks out of the index or out of order would skip lines with matches)
+		std::vector<uint32_t> blocks;
+		for (uint64_t i = 0; i < header.numPostings; i++)
+		{
+			StoredPosting storedPosting;
+			if (!read(&storedPosting, sizeof(StoredPosting)) || (storedPosting.trigram >= NumTrigrams) || (static_cast<size_t>(walkerEnd - walker) < storedPosting.numBytes))
+				break;
+
+			auto& posting = m_postings[storedPosting.trigram];
+			if (!posting.deltas.empty())
+				break;
+
+			posting.deltas.assign(reinterpret_cast<const uint8_t*>(walker), reinterpret_cast<const uint8_t*>(walker + storedPosting.numBytes));
+			posting.lastBlock = storedPosting.lastBlock;
+			posting.numBlocks = storedPosting.numBlocks;
+			walker += storedPosting.numBytes;
+
+			posting.decode(blocks, 0, std::numeric_limits<uint32_t>::max());
+			if (blocks.empty() || (blocks.size() != posting.numBlocks) || (blocks.back() != posting.lastBlock) || (blocks.back() >= numBlocks()) || ((posting.deltas.back() & 0x80) != 0))
+				break;
+			if (std::adjacent_find(blocks.begin(), blocks.end(), [](uint32_t a, uint32_t b) { return (a >= b); }) != blocks.end())
+				break;
+		}
+
+		if ((m_postings.size() != header.numPostings) || (walker != walkerEnd))
+		{
+			m_numLines = 0;
+			m_postings.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TrigramIndex::store(std::ostream& out) const
+	{
+		StoredHeader header;
+		std::memset(&header, 0, sizeof(StoredHeader));
+		header.version = FormatVersion;
+		header.blockSize = static_cast<uint32_t>(BlockSize);
+		header.numLines = m_numLines;
+		header.numPostings = m_postings.size();
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(StoredHeader));
+
+		for (const auto& [trigram, posting] : m_postings)
+		{
+			StoredPosting storedPosting;
+			storedPosting.trigram = trigram;
+			storedPosting.lastBlock = posting.lastBlock;
+			storedPosting.numBlocks = posting.numBlocks;
+			storedPosting.numBytes = static_cast<uint32_t>(posting.deltas.size());
+
+			out.write(reinterpret_cast<const char*>(&storedPosting), sizeof(StoredPosting));
+			out.write(reinterpret_cast<const char*>(posting.deltas.data()), posting.deltas.size());
+		}
+
+		return static_cast<bool>(out);
+	}
+}
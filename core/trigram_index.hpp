@@ -0,0 +1,65 @@
+#ifndef LA_TRIGRAM_INDEX_HPP
+#define LA_TRIGRAM_INDEX_HPP
+
+#include "log_line.hpp"
+
+#include <atomic>
+#include <iosfwd>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace la
+{
+	//the blocks of lines with each trigram (3 bytes, with the ascii letters in lowercase) of their content
+	//a text of 3 or more bytes can only be in the blocks with all its trigrams, the other blocks don't need to be searched
+	class TrigramIndex final
+	{
+	public:
+		static constexpr size_t BlockSize{ 256 }; //lines per block
+
+		//the lines [0, numLines()) are indexed
+		size_t numLines() const noexcept
+		{
+			return m_numLines;
+		}
+
+		size_t numBlocks() const noexcept
+		{
+			return (m_numLines + BlockSize - 1) / BlockSize;
+		}
+
+		//the blocks in [blockStart, blockEnd) which may have "text", in order (none when the text is too short to use the index)
+		std::optional<std::vector<uint32_t>> candidateBlocks(std::string_view text, uint32_t blockStart, uint32_t blockEnd) const;
+
+		//the lines from "numLines" on are removed (with the rest of their block)
+		void truncate(size_t numLines);
+
+		//indexes the lines after the ones already indexed (returns false, with only some of them indexed, when cancelled)
+		bool extend(const std::vector<LogLine>& lines, const std::atomic<bool>& cancel);
+
+		bool load(const char* data, size_t size);
+		bool store(std::ostream& out) const;
+
+	private:
+		//the blocks with a trigram, each one stored as the delta to the previous one (in 7 bit groups, the high bit is set while there are more)
+		struct Posting
+		{
+			std::vector<uint8_t> deltas;
+			uint32_t lastBlock{ 0 };
+			uint32_t numBlocks{ 0 };
+
+			void push(uint32_t block);
+			void pop();
+			void decode(std::vector<uint32_t>& blocks, uint32_t blockStart, uint32_t blockEnd) const;
+		};
+
+	private:
+		size_t m_numLines{ 0 };
+		std::unordered_map<uint32_t, Posting> m_postings;
+	};
+}
+
+#endif
@@ -1,11 +1,18 @@
 #include "utils.hpp"
 
 #include <array>
+#include <mutex>
+#include <atomic>
 #include <chrono>
+#include <thread>
+#include <vector>
 #include <cstring>
 #include <numeric>
 #include <ostream>
 #include <charconv>
+#include <exception>
+#include <algorithm>
+#include <condition_variable>
 
 #if defined(_WIN32) || defined(WIN32)
 	#include <ws2tcpip.h>
@@ -152,6 +159,117 @@ namespace la::utils
 			for (const auto& buffer : buffers)
 				streamOut.write(reinterpret_cast<const char*>(std::get<0>(buffer)), std::get<1>(buffer));
 		}
+
+		//the indices of a "Parallel::forEach" call, taken in order by its caller and by the workers which join it
+		struct ParallelJob
+		{
+			size_t count;
+			const std::function<void(size_t index)>& cb;
+
+			std::atomic<size_t> nextIndex{ 0 };
+			std::atomic<bool> failed{ false };
+			std::exception_ptr exception; //the first one thrown (set under the pool lock)
+
+			size_t numJoinedWorkers{ 0 }; //workers still running indices of the job (under the pool lock)
+
+			ParallelJob(size_t count, const std::function<void(size_t index)>& cb)
+				: count{ count }
+				, cb{ cb }
+			{ }
+		};
+
+		//the threads helping the callers of "Parallel::forEach", created once (the callers always run their own indices too, so nested or concurrent calls never wait for a worker)
+		class ParallelPool final
+		{
+		public:
+			explicit ParallelPool(size_t numThreads)
+			{
+				for (size_t i = 0; i < numThreads; i++)
+					std::thread{ [this]() { workerLoop(); } }.detach();
+			}
+
+			ParallelPool(const ParallelPool&) = delete;
+			ParallelPool& operator=(const ParallelPool&) = delete;
+
+			//returns once all the indices ran (and no worker uses the job anymore), with the first exception rethrown
+			void run(ParallelJob& job)
+			{
+				{
+					std::lock_guard<std::mutex> lock{ m_mutex };
+					m_jobs.push_back(&job);
+				}
+
+				m_cvJobs.notify_all();
+
+				runIndices(job);
+
+				{
+					std::unique_lock<std::mutex> lock{ m_mutex };
+					removeJob(job);
+					m_cvDone.wait(lock, [&job]() { return (job.numJoinedWorkers == 0); });
+				}
+
+				if (job.exception)
+					std::rethrow_exception(job.exception);
+			}
+
+		private:
+			void runIndices(ParallelJob& job)
+			{
+				for (auto index = job.nextIndex++; (index < job.count) && !job.failed; index = job.nextIndex++)
+				{
+					try
+					{
+						job.cb(index);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock{ m_mutex };
+						if (!job.exception)
+							job.exception = std::current_exception();
+
+						job.failed = true;
+					}
+				}
+			}
+
+			void removeJob(ParallelJob& job)
+			{
+				auto itJob = std::find(m_jobs.begin(), m_jobs.end(), &job);
+				if (itJob != m_jobs.end())
+					m_jobs.erase(itJob);
+			}
+
+			void workerLoop()
+			{
+				std::unique_lock<std::mutex> lock{ m_mutex };
+				while (true)
+				{
+					m_cvJobs.wait(lock, [this]() { return !m_jobs.empty(); });
+
+					//the oldest job first, it's the one most likely to have a caller waiting for it
+					auto& job = *m_jobs.front();
+					job.numJoinedWorkers++;
+
+					lock.unlock();
+					runIndices(job);
+					lock.lock();
+
+					//no index is left to take: other workers don't need to join it
+					removeJob(job);
+
+					if (--job.numJoinedWorkers == 0)
+						m_cvDone.notify_all();
+				}
+			}
+
+		private:
+			std::mutex m_mutex;
+			std::condition_variable m_cvJobs;
+			std::condition_variable m_cvDone;
+
+			std::vector<ParallelJob*> m_jobs;
+		};
 	}
 
 	bool Network::writePCAPHeader(std::ostream& streamOut)
@@ -347,4 +465,32 @@ namespace la::utils
 
 		return true;
 	}
+
+	size_t Parallel::numWorkers() noexcept
+	{
+		auto numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+		return ((numThreads > 0) ? numThreads : 1);
+	}
+
+	void Parallel::forEach(size_t count, const std::function<void(size_t index)>& cb)
+	{
+		if ((count <= 0) || !cb)
+			return;
+
+		auto numThreads = std::min(numWorkers(), count);
+		if (numThreads <= 1)
+		{
+			for (size_t i = 0; i < count; i++)
+				cb(i);
+
+			return;
+		}
+
+		//each worker of the pool picks the next available index (the calling thread also works)
+		//the pool is never destroyed: its threads would have to be joined while the statics are destroyed, which can't be done while a dll is unloaded
+		static auto pool = new ParallelPool{ numWorkers() - 1 };
+
+		ParallelJob job{ count, cb };
+		pool->run(job);
+	}
 }
@@ -3,6 +3,7 @@
 
 #include <tuple>
 #include <iosfwd>
+#include <functional>
 #include <string_view>
 
 namespace la::utils
@@ -13,6 +14,14 @@ namespace la::utils
 		static bool writePCAPDataIPV4(std::ostream& streamOut, std::string_view srcAddress, std::string_view dstAddress, int64_t timestamp, std::tuple<const void*, size_t> payload);
 		static bool writePCAPDataIPV6(std::ostream& streamOut, std::string_view srcAddress, std::string_view dstAddress, int64_t timestamp, std::tuple<const void*, size_t> payload);
 	};
+
+	struct Parallel
+	{
+		static size_t numWorkers() noexcept;
+
+		//calls "cb" with each index of [0, count), on the calling thread and on the workers (returns once all the calls are done, rethrowing the first exception)
+		static void forEach(size_t count, const std::function<void(size_t index)>& cb);
+	};
 }
 
 #endif
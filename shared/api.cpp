@@ -40,6 +40,19 @@ namespace
 		return nOptions;
 	}
 
+	la::LinesRepo::CacheOptions convertCacheOptions(const laCacheOptions* options)
+	{
+		if (!options)
+			return {};
+
+		la::LinesRepo::CacheOptions nOptions;
+		nOptions.enabled = (options->enabled != 0);
+		if (options->folderPath.data && (options->folderPath.size > 0))
+			nOptions.folderPath = { options->folderPath.data, static_cast<size_t>(options->folderPath.size) };
+
+		return nOptions;
+	}
+
 	la::LinesRepo::ExportOptions convertExportOptions(const laExportOptions* options)
 	{
 		if (!options)
@@ -167,6 +180,12 @@ laStrUTF8 la_find_ctx_query(const wclFindContext* ctx)
 	return convertStr(nCtx->query());
 }
 
+laStrUTF8 la_find_ctx_query_error(const wclFindContext* ctx)
+{
+	auto nCtx = reinterpret_cast<const la::LinesRepo::FindContext*>(ctx);
+	return convertStr(nCtx->queryError());
+}
+
 int la_find_ctx_line_position(const wclFindContext* ctx, int* lineOffset)
 {
 	auto nCtx = reinterpret_cast<const la::LinesRepo::FindContext*>(ctx);
@@ -235,6 +254,28 @@ wclLinesRepo* la_init_repo_folder_filter(laFlavorType flavor, laStrFixedUTF8 fol
 	return (repo ? reinterpret_cast<wclLinesRepo*>(repo.release()) : nullptr);
 }
 
+wclLinesRepo* la_init_repo_file_cache(laFlavorType flavor, laStrFixedUTF8 filePath, const laCacheOptions* cacheOptions)
+{
+	if (!filePath.data || (filePath.size <= 0))
+		return nullptr;
+
+	auto repo = la::LinesRepo::initRepoFile(static_cast<la::FlavorsRepo::Type>(flavor), { filePath.data, static_cast<size_t>(filePath.size) }, convertCacheOptions(cacheOptions));
+	return (repo ? reinterpret_cast<wclLinesRepo*>(repo.release()) : nullptr);
+}
+
+wclLinesRepo* la_init_repo_folder_cache(laFlavorType flavor, laStrFixedUTF8 folderPath, laStrFixedUTF8 fileNameFilterRegex, const laCacheOptions* cacheOptions)
+{
+	if (!folderPath.data || (folderPath.size <= 0))
+		return nullptr;
+
+	std::string_view fileNameFilter;
+	if (fileNameFilterRegex.data && (fileNameFilterRegex.size > 0))
+		fileNameFilter = { fileNameFilterRegex.data, static_cast<size_t>(fileNameFilterRegex.size) };
+
+	auto repo = la::LinesRepo::initRepoFolder(static_cast<la::FlavorsRepo::Type>(flavor), { folderPath.data, static_cast<size_t>(folderPath.size) }, fileNameFilter, convertCacheOptions(cacheOptions));
+	return (repo ? reinterpret_cast<wclLinesRepo*>(repo.release()) : nullptr);
+}
+
 wclLinesRepo* la_init_repo_command(wclLinesRepo* repo, laStrFixedUTF8 commandResult)
 {
 	if (!repo)
@@ -299,6 +340,20 @@ laFlavorType la_repo_flavor(wclLinesRepo* repo)
 	return static_cast<laFlavorType>(reinterpret_cast<la::LinesRepo*>(repo)->flavor());
 }
 
+int la_repo_refresh(wclLinesRepo* repo, int* numNewLines)
+{
+	if (!repo)
+		return 0;
+
+	auto res = reinterpret_cast<la::LinesRepo*>(repo)->refresh();
+	if (!res)
+		return 0;
+
+	if (numNewLines)
+		*numNewLines = static_cast<int>(*res);
+	return 1;
+}
+
 wclFindContext* la_repo_search_text(wclLinesRepo* repo, laStrFixedUTF8 query, const laFindOptions* findOptions)
 {
 	if (!repo)
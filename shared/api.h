@@ -70,6 +70,12 @@ typedef struct laExportOptions
 	laTranslatorFormat translationFormat;
 } laExportOptions;
 
+typedef struct laCacheOptions
+{
+	int8_t enabled;
+	laStrFixedUTF8 folderPath; //empty to store the indexes next to the files
+} laCacheOptions;
+
 typedef struct wclFindContext wclFindContext;
 
 typedef struct wclLinesRepo wclLinesRepo;
@@ -89,6 +95,7 @@ LA_API_VISIBILITY laStrFixedUTF8 la_str_fixed_init_cstr(const char* cstr);
 
 LA_API_VISIBILITY int la_find_ctx_valid(const wclFindContext* ctx);
 LA_API_VISIBILITY laStrUTF8 la_find_ctx_query(const wclFindContext* ctx);
+LA_API_VISIBILITY laStrUTF8 la_find_ctx_query_error(const wclFindContext* ctx); //empty unless the query can't be searched (e.g. an invalid regex)
 LA_API_VISIBILITY int la_find_ctx_line_position(const wclFindContext* ctx, int* lineOffset);
 
 
@@ -96,12 +103,17 @@ LA_API_VISIBILITY int la_find_ctx_line_position(const wclFindContext* ctx, int*
 ** Repo init and file search
 ********/
 
+//LA_FLAVOR_TYPE_UNKNOWN detects the flavor from the content of the files (la_repo_flavor returns the detected one)
 LA_API_VISIBILITY laStrUTF8* la_list_files(laFlavorType flavor, laStrFixedUTF8 folderPath, int* numFiles);
 
 LA_API_VISIBILITY wclLinesRepo* la_init_repo_file(laFlavorType flavor, laStrFixedUTF8 filePath);
 LA_API_VISIBILITY wclLinesRepo* la_init_repo_folder(laFlavorType flavor, laStrFixedUTF8 folderPath);
 LA_API_VISIBILITY wclLinesRepo* la_init_repo_folder_filter(laFlavorType flavor, laStrFixedUTF8 folderPath, laStrFixedUTF8 fileNameFilterRegex);
 
+//the lines and the search index are cached in indexes next to the files by the other init functions (a null "cacheOptions" does the same)
+LA_API_VISIBILITY wclLinesRepo* la_init_repo_file_cache(laFlavorType flavor, laStrFixedUTF8 filePath, const laCacheOptions* cacheOptions);
+LA_API_VISIBILITY wclLinesRepo* la_init_repo_folder_cache(laFlavorType flavor, laStrFixedUTF8 folderPath, laStrFixedUTF8 fileNameFilterRegex, const laCacheOptions* cacheOptions);
+
 LA_API_VISIBILITY wclLinesRepo* la_init_repo_command(wclLinesRepo* repo, laStrFixedUTF8 commandResult);
 LA_API_VISIBILITY wclLinesRepo* la_init_repo_line_range(wclLinesRepo* repo, int indexStart, int count);
 LA_API_VISIBILITY wclLinesRepo* la_init_repo_tags(wclLinesRepo* repo, laStrFixedUTF8* tags, int tagsSize);
@@ -116,6 +128,8 @@ LA_API_VISIBILITY int la_repo_num_files(wclLinesRepo* repo);
 LA_API_VISIBILITY int la_repo_num_lines(wclLinesRepo* repo);
 LA_API_VISIBILITY laFlavorType la_repo_flavor(wclLinesRepo* repo);
 
+LA_API_VISIBILITY int la_repo_refresh(wclLinesRepo* repo, int* numNewLines);
+
 LA_API_VISIBILITY wclFindContext* la_repo_search_text(wclLinesRepo* repo, laStrFixedUTF8 query, const laFindOptions* findOptions);
 LA_API_VISIBILITY wclFindContext* la_repo_search_text_regex(wclLinesRepo* repo, laStrFixedUTF8 query, const laFindOptions* findOptions);
 LA_API_VISIBILITY void la_repo_search_next(wclLinesRepo* repo, wclFindContext* ctx);
@@ -0,0 +1,115 @@
+#include "reference_lines.hpp"
+
+#include <lines_scanner.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <fstream>
+#include <iterator>
+
+//the speed (GB/s) of delimiting the lines of a file, with the old byte by byte loop and with each level of the LinesScanner
+//usage: bench_lines_scanner [file] (a synthetic log of 256 MB when no file is given)
+namespace
+{
+	using la::LinesScanner;
+
+	constexpr size_t NumRuns{ 5 };
+
+	//lines with the size and shape of the usual logs (a header, a method, a message and params of random sizes)
+	std::string syntheticLog(size_t size)
+	{
+		std::mt19937 random{ 42 };
+		std::uniform_int_distribution<int> textSize{ 10, 250 };
+		std::uniform_int_distribution<int> letter{ 'a', 'z' };
+
+		std::string data;
+		data.reserve(size + 512);
+		while (data.size() < size)
+		{
+			data += "2024-06-01 12:34:56.789 | I | 12345 | COMLib.Scheduler | schedule | task scheduled | id=1; name=";
+			auto numLetters = textSize(random);
+			for (int i = 0; i < numLetters; i++)
+				data += static_cast<char>(letter(random));
+
+			data += "\r\n";
+		}
+
+		return data;
+	}
+
+	template<typename TScan>
+	void bench(const char* name, const std::string& data, TScan scan)
+	{
+		double bestSeconds{ 0.0 };
+		size_t numLines{ 0 };
+		for (size_t run = 0; run < NumRuns; run++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			numLines = scan();
+			std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+			if ((run == 0) || (seconds.count() < bestSeconds))
+				bestSeconds = seconds.count();
+		}
+
+		std::printf("%-10s %8.2f GB/s %12zu lines\n", name, (static_cast<double>(data.size()) / 1e9) / bestSeconds, numLines);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string data;
+	if (argc > 1)
+	{
+		std::ifstream file{ argv[1], std::ios::binary };
+		if (!file)
+		{
+			std::printf("unable to open %s\n", argv[1]);
+			return 1;
+		}
+
+		data.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+	}
+	else
+	{
+		data = syntheticLog(size_t{ 256 } * 1024 * 1024);
+	}
+
+	std::printf("%zu bytes\n", data.size());
+
+	bench("reference", data, [&data]()
+	{
+		size_t numLines{ 0 };
+		la::tests::referenceIterate(data.data(), data.size(), [&numLines](const LinesScanner::Span&) { numLines++; });
+		return numLines;
+	});
+
+	constexpr std::array<std::pair<LinesScanner::Level, const char*>, 3> Levels{ {
+		{ LinesScanner::Level::Scalar, "scalar" },
+		{ LinesScanner::Level::SSE2, "sse2" },
+		{ LinesScanner::Level::AVX2, "avx2" }
+	} };
+
+	for (const auto& [level, name] : Levels)
+	{
+		if (level > LinesScanner::level())
+			continue;
+
+		bench(name, data, [&data, level = level]()
+		{
+			size_t numLines{ 0 };
+
+			LinesScanner scanner{ data.data(), data.size(), level };
+			LinesScanner::Batch batch;
+			while (auto numSpans = scanner.nextBatch(batch))
+				numLines += numSpans;
+
+			return numLines;
+		});
+	}
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include <text_searcher.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+//the time of finding all the matches of a few queries in a file, with the TextSearcher and with the searchers of the standard library
+//usage: bench_text_searcher [file] [query...] (a synthetic log of 128 MB and a few usual queries when they aren't given)
+namespace
+{
+	constexpr size_t NumRuns{ 3 };
+
+	std::string syntheticLog(size_t size)
+	{
+		constexpr std::array<const char*, 6> Msgs{ "task scheduled", "task executing", "request new", "message stored", "SIP/2.0 200 OK Call-ID: call17@host", "message with some text Hello World" };
+
+		std::mt19937 random{ 42 };
+		std::uniform_int_distribution<size_t> msg{ 0, Msgs.size() - 1 };
+		std::uniform_int_distribution<int> id{ 1, 100000 };
+
+		std::string data;
+		data.reserve(size + 512);
+		while (data.size() < size)
+		{
+			char line[256];
+			std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 %d |DEBUG|00|COMLib.Scheduler: schedule | %s | id=%d; name=SyncTask; \n", id(random) % 200, Msgs[msg(random)], id(random));
+			data += line;
+		}
+
+		return data;
+	}
+
+	//finds every match, from the one found on
+	template<typename TSearch>
+	void bench(const char* name, const std::string& data, TSearch search)
+	{
+		double bestSeconds{ 0.0 };
+		size_t numMatches{ 0 };
+		for (size_t run = 0; run < NumRuns; run++)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			numMatches = 0;
+			auto dataEnd = data.data() + data.size();
+			for (auto walker = data.data(); (walker = search(walker, dataEnd)) != dataEnd; walker++)
+				numMatches++;
+
+			std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+			if ((run == 0) || (seconds.count() < bestSeconds))
+				bestSeconds = seconds.count();
+		}
+
+		std::printf("  %-14s %9.1f ms %10zu matches\n", name, bestSeconds * 1000.0, numMatches);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string data;
+	if (argc > 1)
+	{
+		std::ifstream file{ argv[1], std::ios::binary };
+		if (!file)
+		{
+			std::printf("unable to open %s\n", argv[1]);
+			return 1;
+		}
+
+		data.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+	}
+	else
+	{
+		data = syntheticLog(size_t{ 128 } * 1024 * 1024);
+	}
+
+	std::vector<std::string> queries;
+	for (int i = 2; i < argc; i++)
+		queries.emplace_back(argv[i]);
+
+	if (queries.empty())
+		queries = { "zzz-not-there", "Call-ID", "id=", "hello world", "REQUEST FINISHED", "message stored" };
+
+	std::printf("%zu bytes\n", data.size());
+
+	for (const auto& query : queries)
+	{
+		std::printf("\"%s\"\n", query.c_str());
+
+		la::TextSearcher caseSensitive{ query, false };
+		bench("searcher", data, [&caseSensitive](const char* dataStart, const char* dataEnd) { return caseSensitive(dataStart, dataEnd); });
+
+		bench("memchr", data, [&query](const char* dataStart, const char* dataEnd)
+		{
+			auto pos = std::string_view{ dataStart, static_cast<size_t>(dataEnd - dataStart) }.find(query);
+			return ((pos != std::string_view::npos) ? (dataStart + pos) : dataEnd);
+		});
+
+		std::boyer_moore_searcher bmSearcher{ query.begin(), query.end() };
+		bench("boyer moore", data, [&bmSearcher](const char* dataStart, const char* dataEnd) { return std::search(dataStart, dataEnd, bmSearcher); });
+
+		la::TextSearcher ignoreCase{ query, true };
+		bench("searcher (ci)", data, [&ignoreCase](const char* dataStart, const char* dataEnd) { return ignoreCase(dataStart, dataEnd); });
+	}
+
+	return 0;
+}
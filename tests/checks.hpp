@@ -0,0 +1,34 @@
+#ifndef LA_TESTS_CHECKS_HPP
+#define LA_TESTS_CHECKS_HPP
+
+#include <cstdio>
+
+namespace la::tests
+{
+	//the checks which failed, reported by the exit code of the test (only the first ones are printed)
+	inline size_t NumFailures{ 0 };
+	constexpr size_t MaxPrintedFailures{ 20 };
+
+	inline bool check(bool condition, const char* expression, const char* file, int line)
+	{
+		if (condition)
+			return true;
+
+		if (NumFailures++ < MaxPrintedFailures)
+			std::printf("%s:%d: check failed: %s\n", file, line, expression);
+
+		return false;
+	}
+
+	inline int result()
+	{
+		if (NumFailures > 0)
+			std::printf("%zu checks failed\n", NumFailures);
+
+		return (NumFailures > 0) ? 1 : 0;
+	}
+}
+
+#define LA_CHECK(expression) la::tests::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif
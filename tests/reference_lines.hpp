@@ -0,0 +1,44 @@
+#ifndef LA_TESTS_REFERENCE_LINES_HPP
+#define LA_TESTS_REFERENCE_LINES_HPP
+
+#include <lines_scanner.hpp>
+
+#include <vector>
+
+namespace la::tests
+{
+	//the lines of the data as delimited by the byte by byte loop used before the LinesScanner (the reference for its results)
+	template<typename TCallback>
+	void referenceIterate(const char* data, size_t dataSize, TCallback callback)
+	{
+		auto walker = data;
+		auto walkerEnd = data + dataSize;
+		while (walker < walkerEnd)
+		{
+			LinesScanner::Span line{ walker, walker };
+
+			while ((walker < walkerEnd) && (walker[0] != '\n') && (walker[0] != '\r'))
+				walker++;
+
+			line.end = walker;
+
+			if ((walker < walkerEnd) && ((walker[0] == '\n') || (walker[0] == '\r')))
+				walker++;
+
+			//consume '\0's for the next line
+			while ((walker < walkerEnd) && (walker[0] == '\0'))
+				walker++;
+
+			callback(line);
+		}
+	}
+
+	inline std::vector<LinesScanner::Span> referenceLines(const char* data, size_t dataSize)
+	{
+		std::vector<LinesScanner::Span> lines;
+		referenceIterate(data, dataSize, [&lines](const LinesScanner::Span& line) { lines.push_back(line); });
+		return lines;
+	}
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "checks.hpp"
+
+#include <flavors_repo.hpp>
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <string_view>
+
+namespace
+{
+	//valid lines mixed with what the parser takes as multiline content (empty lines, '\r', '\0's, text), sometimes before the first line too
+	std::string randomFile(std::mt19937& random)
+	{
+		constexpr std::array<std::string_view, 6> Contents{ "", "\r", "  at frame 3", std::string_view{ "\0\0", 2 }, "task | id=3; name=x;", "2023-03-26 00:53" };
+		std::uniform_int_distribution<size_t> pickContent{ 0, Contents.size() - 1 };
+		std::uniform_int_distribution<int> id{ 1, 40 };
+
+		std::string data;
+		auto numLines = std::uniform_int_distribution<size_t>{ 0, 60 }(random);
+		for (size_t i = 0; i < numLines; i++)
+		{
+			if (std::uniform_int_distribution<int>{ 0, 3 }(random) == 0)
+			{
+				data += Contents[pickContent(random)];
+			}
+			else
+			{
+				char line[256];
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.%03d %d |DEBUG|00|COMLib.Scheduler: run | task executing | id=%d; name=Task%d; ", static_cast<int>(i), id(random), id(random), id(random));
+				data += line;
+			}
+
+			if (std::uniform_int_distribution<int>{ 0, 5 }(random) == 0)
+				data += '\r';
+			if (std::uniform_int_distribution<int>{ 0, 10 }(random) != 0)
+				data += '\n';
+		}
+
+		return data;
+	}
+
+	struct ParsedLines
+	{
+		std::vector<la::LogLine> lines;
+		std::vector<la::LogLineHeader> headers;
+	};
+
+	//each file parsed in one go (so the content before the first line of a file is dropped)
+	ParsedLines parseSerial(const std::vector<std::string>& files)
+	{
+		ParsedLines parsed;
+		for (const auto& file : files)
+		{
+			ParsedLines fileParsed;
+			la::FlavorsRepo::processFileData(la::FlavorsRepo::Type::WCSCOMLib, file.data(), file.size(), fileParsed.lines, fileParsed.headers);
+
+			parsed.lines.insert(parsed.lines.end(), fileParsed.lines.begin(), fileParsed.lines.end());
+			parsed.headers.insert(parsed.headers.end(), fileParsed.headers.begin(), fileParsed.headers.end());
+		}
+
+		return parsed;
+	}
+
+	//the files split in chunks parsed on their own, then merged as the repo does (the leading content of a chunk goes to the previous line of its file)
+	ParsedLines parseChunked(const std::vector<std::string>& files, size_t chunkSize)
+	{
+		ParsedLines parsed;
+		for (const auto& file : files)
+		{
+			auto fileFirstLine = parsed.lines.size();
+
+			auto chunks = la::FlavorsRepo::splitFileData(file.data(), file.size(), chunkSize);
+
+			//the chunks are the whole file, in order
+			const char* chunkStart = file.data();
+			for (const auto& chunk : chunks)
+			{
+				LA_CHECK((chunk.data() == chunkStart) && !chunk.empty());
+				chunkStart = chunk.data() + chunk.size();
+			}
+			LA_CHECK(chunkStart == (file.data() + file.size()));
+
+			for (const auto& chunk : chunks)
+			{
+				ParsedLines chunkParsed;
+				const char* leadingContentEnd{ nullptr };
+				la::FlavorsRepo::processFileData(la::FlavorsRepo::Type::WCSCOMLib, chunk.data(), chunk.size(), chunkParsed.lines, chunkParsed.headers, &leadingContentEnd);
+
+				if (leadingContentEnd && (parsed.lines.size() > fileFirstLine))
+					la::FlavorsRepo::appendMultilineContent(parsed.lines.back(), leadingContentEnd);
+
+				parsed.lines.insert(parsed.lines.end(), chunkParsed.lines.begin(), chunkParsed.lines.end());
+				parsed.headers.insert(parsed.headers.end(), chunkParsed.headers.begin(), chunkParsed.headers.end());
+			}
+		}
+
+		return parsed;
+	}
+
+	bool sameLines(const ParsedLines& expected, const ParsedLines& result)
+	{
+		if ((expected.lines.size() != result.lines.size()) || (expected.headers.size() != result.headers.size()))
+			return false;
+
+		for (size_t i = 0; i < expected.lines.size(); i++)
+		{
+			const auto& expectedLine = expected.lines[i];
+			const auto& line = result.lines[i];
+			if ((line.dataStart != expectedLine.dataStart) || (line.dataSize != expectedLine.dataSize))
+				return false;
+
+			const auto& expectedSections = expectedLine.sections;
+			const auto& sections = line.sections;
+			if ((sections.offsets != expectedSections.offsets) || (sections.shortSizes != expectedSections.shortSizes) || (sections.paramsGap != expectedSections.paramsGap) || (sections.longSizes != expectedSections.longSizes))
+				return false;
+
+			const auto& expectedHeader = expected.headers[i];
+			const auto& header = result.headers[i];
+			if ((header.timestamp != expectedHeader.timestamp) || (header.threadId != expectedHeader.threadId) || (header.level != expectedHeader.level))
+				return false;
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	constexpr size_t NumRounds{ 3000 };
+
+	std::mt19937 random{ 1357 };
+
+	size_t numLines{ 0 };
+	for (size_t round = 0; round < NumRounds; round++)
+	{
+		std::vector<std::string> files(std::uniform_int_distribution<size_t>{ 1, 3 }(random));
+		for (auto& file : files)
+			file = randomFile(random);
+
+		auto expected = parseSerial(files);
+		numLines += expected.lines.size();
+
+		//from chunks smaller than a line to chunks bigger than the files
+		auto chunkSize = std::uniform_int_distribution<size_t>{ 0, 3000 }(random);
+		if (!LA_CHECK(sameLines(expected, parseChunked(files, chunkSize))))
+			std::printf("  round %zu, %zu files, chunks of %zu bytes\n", round, files.size(), chunkSize);
+	}
+
+	std::printf("%zu rounds checked (%zu lines)\n", NumRounds, numLines);
+	return la::tests::result();
+}
@@ -0,0 +1,196 @@
+#include "checks.hpp"
+
+#include <lines_repo.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+
+namespace
+{
+	//some files start with multiline content (dropped, as it has no line before it in its file)
+	std::string syntheticLog(std::mt19937& random, size_t numLines, bool leadingContent)
+	{
+		constexpr std::array<const char*, 4> Msgs{ "task executing", "task finishing", "task waiting (sync)", "removed task" };
+
+		std::uniform_int_distribution<size_t> pickMsg{ 0, Msgs.size() - 1 };
+		std::uniform_int_distribution<int> id{ 1, 40 };
+
+		std::string data{ leadingContent ? "  at frame 1\n" : "" };
+		for (size_t i = 0; i < numLines; i++)
+		{
+			char line[256];
+			std::snprintf(line, sizeof(line), "2023-03-26 00:53:%02d.%03d %d |%s|00|COMLib.Scheduler: run | %s | id=%d; name=Task%d; \n", static_cast<int>((i / 1000) % 60), static_cast<int>(i % 1000), id(random), (i % 7 == 0) ? "INFO " : "DEBUG", Msgs[pickMsg(random)], id(random), id(random));
+			data += line;
+
+			if (std::uniform_int_distribution<int>{ 0, 9 }(random) == 0)
+				data += "  at frame " + std::to_string(id(random)) + "\n";
+		}
+
+		return data;
+	}
+
+	void writeFile(const std::filesystem::path& path, std::string_view data, bool append)
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+		out.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	//the files whose name ends with "suffix" (the indexes next to the logs are only named by it)
+	size_t countFiles(const std::filesystem::path& folderPath, std::string_view suffix)
+	{
+		size_t numFiles{ 0 };
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(folderPath, ec))
+		{
+			auto name = entry.path().filename().u8string();
+			if ((name.size() >= suffix.size()) && (std::string_view{ name }.substr(name.size() - suffix.size()) == suffix))
+				numFiles++;
+		}
+
+		return numFiles;
+	}
+
+	std::unique_ptr<la::LinesRepo> initRepo(const std::filesystem::path& folderPath, bool cacheEnabled, const std::filesystem::path& cacheFolderPath)
+	{
+		auto cacheFolder = cacheFolderPath.u8string();
+		return la::LinesRepo::initRepoFolder(la::FlavorsRepo::Type::WCSCOMLib, folderPath.u8string(), {}, { cacheEnabled, cacheFolder });
+	}
+
+	//a repo loaded from an index has the lines of a parsed one, with the same content and sections
+	bool sameLines(const la::LinesRepo& cachedRepo, const std::filesystem::path& folderPath)
+	{
+		auto repo = initRepo(folderPath, false, {});
+		if (!repo || (repo->numFiles() != cachedRepo.numFiles()) || (repo->numLines() != cachedRepo.numLines()))
+			return false;
+
+		for (size_t i = 0; i < repo->numLines(); i++)
+		{
+			for (auto format : { la::TranslatorsRepo::Format::Line, la::TranslatorsRepo::Format::JSONSingleParams })
+			{
+				if (cachedRepo.retrieveLineContent(i, la::TranslatorsRepo::Type::Raw, format) != repo->retrieveLineContent(i, la::TranslatorsRepo::Type::Raw, format))
+				{
+					std::printf("  line %zu differs\n", i);
+					return false;
+				}
+			}
+		}
+
+		return (cachedRepo.findAll("id=7;", la::LinesRepo::FindOptions::CaseSensitivity::None) == repo->findAll("id=7;", la::LinesRepo::FindOptions::CaseSensitivity::None));
+	}
+
+	//the search index is stored by the repo once it's built, in the background
+	bool waitForFile(const std::filesystem::path& folderPath, std::string_view suffix)
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			if (countFiles(folderPath, suffix) > 0)
+				return true;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+		}
+
+		return false;
+	}
+}
+
+int main()
+{
+	constexpr size_t NumTruncations{ 10 };
+
+	std::mt19937 random{ 97531 };
+
+	auto testPath = std::filesystem::temp_directory_path() / "la_test_lines_cache";
+	auto folderPath = testPath / "logs";
+	auto cacheFolderPath = testPath / "cache";
+
+	std::filesystem::remove_all(testPath);
+	std::filesystem::create_directories(folderPath);
+
+	writeFile(folderPath / "comlib.002.log", syntheticLog(random, 3000, false), false);
+	writeFile(folderPath / "comlib.001.log", syntheticLog(random, 2000, true), false);
+	writeFile(folderPath / "comlib.000.log", syntheticLog(random, 1000, true), false);
+
+	//the indexes go to the cache folder (created with the first one), not next to the logs...
+	{
+		auto repo = initRepo(folderPath, true, cacheFolderPath);
+		if (!LA_CHECK(repo))
+			return la::tests::result();
+
+		LA_CHECK(!repo->loadedFromCache());
+		LA_CHECK(countFiles(cacheFolderPath, ".la_lines_index") == 1);
+		LA_CHECK(waitForFile(cacheFolderPath, ".la_search_index"));
+		LA_CHECK(countFiles(folderPath, ".la_lines_index") == 0);
+	}
+
+	//... where the next repo finds them, with the lines rebased to the new mappings of the files
+	{
+		auto repo = initRepo(folderPath, true, cacheFolderPath);
+		LA_CHECK(repo && repo->loadedFromCache());
+		LA_CHECK(repo && sameLines(*repo, folderPath));
+	}
+
+	//by default, they are next to the logs
+	{
+		auto repo = initRepo(folderPath, true, {});
+		LA_CHECK(repo && !repo->loadedFromCache());
+		LA_CHECK(std::filesystem::exists(folderPath / ".la_lines_index"));
+
+		repo = initRepo(folderPath, true, {});
+		LA_CHECK(repo && repo->loadedFromCache());
+		LA_CHECK(repo && sameLines(*repo, folderPath));
+	}
+
+	//an index of files that changed isn't used (and is replaced)
+	writeFile(folderPath / "comlib.000.log", syntheticLog(random, 10, false), true);
+	{
+		auto repo = initRepo(folderPath, true, cacheFolderPath);
+		LA_CHECK(repo && !repo->loadedFromCache());
+		LA_CHECK(repo && sameLines(*repo, folderPath));
+
+		repo = initRepo(folderPath, true, cacheFolderPath);
+		LA_CHECK(repo && repo->loadedFromCache());
+	}
+
+	//nor is an incomplete index
+	auto indexPath = folderPath / ".la_lines_index";
+	{
+		auto repo = initRepo(folderPath, true, {});
+		LA_CHECK(repo && !repo->loadedFromCache());
+	}
+
+	auto indexSize = std::filesystem::file_size(indexPath);
+	for (size_t truncation = 0; truncation < NumTruncations; truncation++)
+	{
+		std::filesystem::resize_file(indexPath, std::uniform_int_distribution<uintmax_t>{ 0, indexSize - 1 }(random));
+
+		auto repo = initRepo(folderPath, true, {});
+		LA_CHECK(repo && !repo->loadedFromCache());
+		LA_CHECK(repo && sameLines(*repo, folderPath));
+		LA_CHECK(std::filesystem::file_size(indexPath) == indexSize);
+	}
+
+	//without the cache, nothing is loaded or stored
+	std::filesystem::remove_all(cacheFolderPath);
+	std::filesystem::remove(indexPath);
+	{
+		auto repo = initRepo(folderPath, false, cacheFolderPath);
+		LA_CHECK(repo && !repo->loadedFromCache());
+	}
+
+	LA_CHECK(!std::filesystem::exists(cacheFolderPath));
+	LA_CHECK(countFiles(folderPath, ".la_lines_index") == 0);
+
+	std::filesystem::remove_all(testPath);
+
+	std::printf("%zu truncated indexes checked\n", NumTruncations);
+	return la::tests::result();
+}
@@ -0,0 +1,124 @@
+#include "checks.hpp"
+
+#include <lines_repo.hpp>
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+namespace
+{
+	//lines with multiline content, so a refresh may cut a line in its content or between its lines
+	std::string syntheticLog(std::mt19937& random, size_t numLines)
+	{
+		constexpr std::array<const char*, 4> Msgs{ "task executing", "task finishing", "task waiting (sync)", "removed task" };
+
+		std::uniform_int_distribution<size_t> pickMsg{ 0, Msgs.size() - 1 };
+		std::uniform_int_distribution<int> id{ 1, 40 };
+
+		std::string data;
+		for (size_t i = 0; i < numLines; i++)
+		{
+			char line[256];
+			std::snprintf(line, sizeof(line), "2023-03-26 00:53:%02d.%03d %d |DEBUG|00|COMLib.Scheduler: run | %s | id=%d; name=Task%d; \n", static_cast<int>((i / 1000) % 60), static_cast<int>(i % 1000), id(random), Msgs[pickMsg(random)], id(random), id(random));
+			data += line;
+
+			if (std::uniform_int_distribution<int>{ 0, 9 }(random) == 0)
+				data += "  at frame " + std::to_string(id(random)) + "\n";
+		}
+
+		return data;
+	}
+
+	void appendToFile(const std::filesystem::path& path, std::string_view data)
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::app);
+		out.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	//a refreshed repo has the lines a new repo has, with the same content and sections
+	bool sameLines(const la::LinesRepo& refreshedRepo, const std::filesystem::path& folderPath)
+	{
+		auto repo = la::LinesRepo::initRepoFolder(la::FlavorsRepo::Type::WCSCOMLib, folderPath.u8string(), {}, { false, {} });
+		if (!repo || (repo->numFiles() != refreshedRepo.numFiles()) || (repo->numLines() != refreshedRepo.numLines()))
+			return false;
+
+		for (size_t i = 0; i < repo->numLines(); i++)
+		{
+			for (auto format : { la::TranslatorsRepo::Format::Line, la::TranslatorsRepo::Format::JSONSingleParams })
+			{
+				if (refreshedRepo.retrieveLineContent(i, la::TranslatorsRepo::Type::Raw, format) != repo->retrieveLineContent(i, la::TranslatorsRepo::Type::Raw, format))
+				{
+					std::printf("  line %zu differs\n", i);
+					return false;
+				}
+			}
+		}
+
+		return (refreshedRepo.findAll("id=7;", la::LinesRepo::FindOptions::CaseSensitivity::None) == repo->findAll("id=7;", la::LinesRepo::FindOptions::CaseSensitivity::None));
+	}
+}
+
+int main()
+{
+	constexpr size_t NumAppends{ 20 };
+
+	std::mt19937 random{ 2468 };
+
+	auto folderPath = std::filesystem::temp_directory_path() / "la_test_lines_repo_refresh";
+	std::filesystem::remove_all(folderPath);
+	std::filesystem::create_directories(folderPath);
+
+	auto data = syntheticLog(random, 6000);
+	auto newestPath = folderPath / "comlib.000.log";
+
+	//the data is added to the newest file in random parts (most of them end inside a line)...
+	size_t written = std::uniform_int_distribution<size_t>{ 1, data.size() / 4 }(random);
+	appendToFile(newestPath, { data.data(), written });
+
+	auto repo = la::LinesRepo::initRepoFolder(la::FlavorsRepo::Type::WCSCOMLib, folderPath.u8string(), {}, { false, {} });
+	if (!LA_CHECK(repo))
+		return la::tests::result();
+
+	LA_CHECK(sameLines(*repo, folderPath));
+
+	auto rotateAt = data.size() / 2;
+	for (size_t append = 0; append < NumAppends; append++)
+	{
+		auto end = std::min(data.size(), written + std::uniform_int_distribution<size_t>{ 0, data.size() / (NumAppends / 2) }(random));
+
+		//... and once, the newest file is rotated (renamed as the previous one, the rest of the data goes to a new one)
+		if ((written < rotateAt) && (end >= rotateAt))
+		{
+			std::filesystem::rename(newestPath, folderPath / "comlib.001.log");
+			end = rotateAt;
+		}
+
+		appendToFile(newestPath, { data.data() + written, end - written });
+		written = end;
+
+		auto numLines = repo->numLines();
+		auto numNewLines = repo->refresh();
+		if (!LA_CHECK(numNewLines.has_value()))
+			break;
+
+		LA_CHECK(numNewLines.value() == (repo->numLines() - numLines));
+		if (!LA_CHECK(sameLines(*repo, folderPath)))
+			std::printf("  after %zu bytes (append %zu)\n", written, append);
+	}
+
+	LA_CHECK(repo->numFiles() == 2);
+
+	//without its newest file the repo can't be refreshed, it must be created again
+	std::filesystem::rename(newestPath, folderPath / "comlib.000.log.old");
+	LA_CHECK(!repo->refresh().has_value());
+
+	repo.reset();
+	std::filesystem::remove_all(folderPath);
+
+	std::printf("%zu refreshes checked\n", NumAppends);
+	return la::tests::result();
+}
@@ -0,0 +1,106 @@
+#include "checks.hpp"
+#include "reference_lines.hpp"
+
+#include <lines_scanner.hpp>
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+	using la::LinesScanner;
+
+	//random data where line breaks and '\0's are frequent (runs of them, "\r\n", breaks at the block boundaries, etc.)
+	std::string randomData(std::mt19937& random, size_t size)
+	{
+		constexpr std::array<char, 8> Chars{ 'a', 'b', ' ', '|', '\n', '\r', '\0', '\n' };
+
+		//the density of line breaks changes per data, from dense to a few long lines
+		auto textWeight = std::uniform_int_distribution<int>{ 1, 200 }(random);
+		std::uniform_int_distribution<int> pick{ 0, textWeight + static_cast<int>(Chars.size()) - 1 };
+
+		std::string data(size, 'x');
+		for (auto& c : data)
+		{
+			auto index = pick(random) - textWeight;
+			c = (index < 0) ? 'x' : Chars[static_cast<size_t>(index)];
+		}
+
+		return data;
+	}
+
+	bool sameLines(const std::vector<LinesScanner::Span>& lines, const std::vector<LinesScanner::Span>& expected)
+	{
+		if (lines.size() != expected.size())
+			return false;
+
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			if ((lines[i].start != expected[i].start) || (lines[i].end != expected[i].end))
+				return false;
+		}
+
+		return true;
+	}
+
+	std::vector<LinesScanner::Span> batchLines(const char* data, size_t dataSize, LinesScanner::Level level)
+	{
+		std::vector<LinesScanner::Span> lines;
+
+		LinesScanner scanner{ data, dataSize, level };
+		LinesScanner::Batch batch;
+		while (auto numSpans = scanner.nextBatch(batch))
+			lines.insert(lines.end(), batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(numSpans));
+
+		return lines;
+	}
+
+	std::vector<LinesScanner::Span> singleLines(const char* data, size_t dataSize, LinesScanner::Level level)
+	{
+		std::vector<LinesScanner::Span> lines;
+
+		LinesScanner scanner{ data, dataSize, level };
+		LinesScanner::Span span;
+		while (scanner.nextLine(span))
+			lines.push_back(span);
+
+		return lines;
+	}
+}
+
+int main()
+{
+	constexpr std::array<LinesScanner::Level, 3> Levels{ LinesScanner::Level::Scalar, LinesScanner::Level::SSE2, LinesScanner::Level::AVX2 };
+	constexpr size_t NumRounds{ 4000 };
+
+	std::mt19937 random{ 20240601 };
+
+	for (size_t round = 0; round < NumRounds; round++)
+	{
+		//mostly small data (partial blocks), some big enough for several batches
+		auto size = ((round % 10) == 0) ? std::uniform_int_distribution<size_t>{ 0, 40000 }(random) : std::uniform_int_distribution<size_t>{ 0, 300 }(random);
+		auto data = randomData(random, size);
+
+		//the data doesn't always start aligned
+		auto offset = std::min<size_t>(round % 7, data.size());
+		auto start = data.data() + offset;
+		auto dataSize = data.size() - offset;
+
+		auto expected = la::tests::referenceLines(start, dataSize);
+		for (auto level : Levels)
+		{
+			if (level > LinesScanner::level())
+				continue;
+
+			if (!LA_CHECK(sameLines(batchLines(start, dataSize, level), expected)) || !LA_CHECK(sameLines(singleLines(start, dataSize, level), expected)))
+				std::printf("  round %zu: %zu bytes at offset %zu, level %d\n", round, dataSize, offset, static_cast<int>(level));
+		}
+	}
+
+	std::printf("%zu rounds checked up to level %d\n", NumRounds, static_cast<int>(LinesScanner::level()));
+	return la::tests::result();
+}
@@ -0,0 +1,206 @@
+#include "checks.hpp"
+
+#include <lines_tools.hpp>
+#include <flavors_repo.hpp>
+#include <multi_searcher.hpp>
+#include <trigram_index.hpp>
+
+#include <array>
+#include <tuple>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+	//a small alphabet, so the queries are found often and overlap each other
+	std::string randomText(std::mt19937& random, size_t size)
+	{
+		constexpr std::string_view Chars{ "abcab=; " };
+		std::uniform_int_distribution<size_t> pick{ 0, Chars.size() - 1 };
+
+		std::string text(size, ' ');
+		for (auto& c : text)
+			c = Chars[pick(random)];
+
+		return text;
+	}
+
+	//every (query, match start) of the queries in the data, by a plain search of each query
+	std::vector<std::tuple<size_t, size_t>> expectedMatches(const std::string& data, const std::vector<std::string>& queries)
+	{
+		std::vector<std::tuple<size_t, size_t>> matches;
+		for (size_t queryIndex = 0; queryIndex < queries.size(); queryIndex++)
+		{
+			if (queries[queryIndex].empty())
+				continue;
+
+			for (auto pos = data.find(queries[queryIndex]); pos != std::string::npos; pos = data.find(queries[queryIndex], pos + 1))
+				matches.emplace_back(queryIndex, pos);
+		}
+
+		std::sort(matches.begin(), matches.end());
+		return matches;
+	}
+
+	void checkSearcher(std::mt19937& random)
+	{
+		std::vector<std::string> queries;
+		auto numQueries = std::uniform_int_distribution<size_t>{ 1, 6 }(random);
+		for (size_t i = 0; i < numQueries; i++)
+			queries.push_back(randomText(random, std::uniform_int_distribution<size_t>{ 0, 5 }(random)));
+
+		//sometimes the queries share a long part, so the searcher looks for it first
+		if (std::uniform_int_distribution<int>{ 0, 2 }(random) == 0)
+		{
+			for (auto& query : queries)
+				query += "=ab;";
+		}
+
+		auto data = randomText(random, std::uniform_int_distribution<size_t>{ 0, 300 }(random));
+		if (!data.empty())
+		{
+			const auto& query = queries[std::uniform_int_distribution<size_t>{ 0, queries.size() - 1 }(random)];
+			auto pos = std::uniform_int_distribution<size_t>{ 0, data.size() - 1 }(random);
+			data.replace(pos, std::min(query.size(), data.size() - pos), query.substr(0, data.size() - pos));
+		}
+
+		la::MultiSearcher searcher{ queries };
+		auto dataStart = data.data();
+		auto dataEnd = dataStart + data.size();
+
+		//all the matches are reported, in the order they end
+		std::vector<std::tuple<size_t, size_t>> matches;
+		size_t lastMatchEnd{ 0 };
+		bool inOrder{ true };
+
+		searcher(dataStart, dataEnd, [&](size_t queryIndex, const char* matchStart)
+		{
+			auto matchEnd = static_cast<size_t>(matchStart - dataStart) + queries[queryIndex].size();
+			inOrder &= (matchEnd >= lastMatchEnd);
+			lastMatchEnd = matchEnd;
+
+			matches.emplace_back(queryIndex, static_cast<size_t>(matchStart - dataStart));
+			return true;
+		});
+
+		std::sort(matches.begin(), matches.end());
+
+		LA_CHECK(inOrder);
+		if (!LA_CHECK(matches == expectedMatches(data, queries)))
+			std::printf("  %zu queries (first \"%s\") in \"%s\"\n", queries.size(), queries[0].c_str(), data.c_str());
+
+		//the candidate never skips a match
+		auto candidate = searcher.findCandidate(dataStart, dataEnd);
+		for (const auto& [queryIndex, matchStart] : matches)
+			LA_CHECK(candidate < (dataStart + matchStart + queries[queryIndex].size()));
+	}
+
+	std::string syntheticLog(size_t numLines)
+	{
+		constexpr std::array<const char*, 4> Msgs{ "task executing", "task finishing", "task waiting (sync)", "removed task" };
+
+		std::mt19937 random{ 11 };
+		std::uniform_int_distribution<size_t> pickMsg{ 0, Msgs.size() - 1 };
+		std::uniform_int_distribution<int> id{ 1, 40 };
+
+		std::string data;
+		for (size_t i = 0; i < numLines; i++)
+		{
+			char line[256];
+			std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 1 |DEBUG|00|COMLib.Scheduler: run | %s | id=%d; name=Task%d; \n", Msgs[pickMsg(random)], id(random), id(random));
+			data += line;
+		}
+
+		return data;
+	}
+
+	void checkWindowFindAllMulti(const la::LinesTools& linesTools, std::mt19937& random)
+	{
+		constexpr std::array<const char*, 5> Queries{ "| task executing | id={}; name=", "| task finishing | id={}; name=", "| task waiting (sync) | id={};", "| removed task | id={};", "name=Task{};" };
+
+		auto numLines = linesTools.lines().size();
+		auto taskId = std::to_string(std::uniform_int_distribution<int>{ 1, 40 }(random));
+
+		std::vector<std::string> queries;
+		for (std::string query : Queries)
+		{
+			if (std::uniform_int_distribution<int>{ 0, 1 }(random) == 0)
+				query.replace(query.find("{}"), 2, taskId);
+			else
+				query.replace(query.find("{}"), 2, taskId + "0"); //mostly not found
+
+			queries.push_back(std::move(query));
+		}
+
+		auto start = std::uniform_int_distribution<size_t>{ 0, numLines }(random);
+		auto end = std::uniform_int_distribution<size_t>{ start, numLines }(random);
+
+		//the same pairs as a search of each query, by line and then by query
+		std::vector<std::tuple<size_t, size_t>> expected;
+		for (size_t queryIndex = 0; queryIndex < queries.size(); queryIndex++)
+		{
+			for (auto lineIndex : linesTools.windowFindAll({ start, end }, queries[queryIndex]))
+				expected.emplace_back(lineIndex, queryIndex);
+		}
+
+		std::sort(expected.begin(), expected.end());
+
+		//and the search stops when the callback says so
+		auto maxMatches = std::uniform_int_distribution<size_t>{ 0, expected.size() + 1 }(random);
+
+		std::vector<std::tuple<size_t, size_t>> result;
+		linesTools.windowFindAllMulti({ start, end }, la::MultiSearcher{ queries }, [&result, maxMatches](size_t queryIndex, size_t lineIndex)
+		{
+			result.emplace_back(lineIndex, queryIndex);
+			return (result.size() < maxMatches);
+		});
+
+		expected.resize(std::min(expected.size(), std::max<size_t>(maxMatches, 1)));
+		if (!LA_CHECK(result == expected))
+			std::printf("  task %s in [%zu, %zu), up to %zu matches\n", taskId.c_str(), start, end, maxMatches);
+	}
+}
+
+int main()
+{
+	constexpr size_t NumSearcherRounds{ 20000 };
+	constexpr size_t NumWindowRounds{ 300 };
+
+	std::mt19937 random{ 4321 };
+
+	for (size_t round = 0; round < NumSearcherRounds; round++)
+		checkSearcher(random);
+
+	auto data = syntheticLog(20000);
+
+	std::vector<la::LogLine> lines;
+	std::vector<la::LogLineHeader> headers;
+	la::FlavorsRepo::processFileData(la::FlavorsRepo::Type::WCSCOMLib, data.data(), data.size(), lines, headers);
+	LA_CHECK(!lines.empty());
+
+	la::LinesTools linesTools{ lines };
+	linesTools.resizeHeaders(headers.size());
+	for (size_t i = 0; i < headers.size(); i++)
+		linesTools.setHeader(i, headers[i]);
+	linesTools.updateColumns(0);
+
+	//without the search index, and then with it (through the literal the queries share, or the candidate blocks of each one)
+	for (size_t round = 0; round < NumWindowRounds; round++)
+		checkWindowFindAllMulti(linesTools, random);
+
+	auto searchIndex = std::make_shared<la::TrigramIndex>();
+	std::atomic<bool> cancel{ false };
+	LA_CHECK(searchIndex->extend(lines, cancel));
+	linesTools.setSearchIndex(searchIndex);
+
+	for (size_t round = 0; round < NumWindowRounds; round++)
+		checkWindowFindAllMulti(linesTools, random);
+
+	std::printf("%zu searcher and %zu window rounds checked\n", NumSearcherRounds, 2 * NumWindowRounds);
+	return la::tests::result();
+}
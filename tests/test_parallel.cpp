@@ -0,0 +1,94 @@
+#include "checks.hpp"
+
+#include <utils.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+namespace
+{
+	//every index is given exactly once
+	bool runsEachIndexOnce(size_t count)
+	{
+		std::vector<std::atomic<int>> calls(count);
+		la::utils::Parallel::forEach(count, [&calls](size_t index) { calls[index]++; });
+
+		for (const auto& numCalls : calls)
+		{
+			if (numCalls != 1)
+				return false;
+		}
+
+		return true;
+	}
+
+	//the first exception is rethrown once no call runs anymore (the ones still running can use the caller's data)
+	bool rethrowsAfterAllCalls(size_t count, size_t throwingIndex)
+	{
+		std::atomic<size_t> numRunning{ 0 };
+
+		try
+		{
+			la::utils::Parallel::forEach(count, [&numRunning, throwingIndex](size_t index)
+			{
+				numRunning++;
+				std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+				numRunning--;
+
+				if (index == throwingIndex)
+					throw std::runtime_error{ "index" };
+			});
+		}
+		catch (const std::runtime_error&)
+		{
+			return (numRunning == 0);
+		}
+
+		return false;
+	}
+}
+
+int main()
+{
+	constexpr size_t NumRounds{ 200 };
+
+	for (size_t round = 0; round < NumRounds; round++)
+		LA_CHECK(runsEachIndexOnce(round * 7));
+
+	//nested calls, and calls from several threads at once, don't wait for each other
+	{
+		std::atomic<size_t> numCalls{ 0 };
+		la::utils::Parallel::forEach(64, [&numCalls](size_t)
+		{
+			la::utils::Parallel::forEach(64, [&numCalls](size_t) { numCalls++; });
+		});
+
+		LA_CHECK(numCalls == (64 * 64));
+	}
+
+	{
+		std::vector<std::thread> threads;
+		std::atomic<bool> valid{ true };
+		for (size_t i = 0; i < 8; i++)
+			threads.emplace_back([&valid]() { valid = (valid && runsEachIndexOnce(5000)); });
+
+		for (auto& thread : threads)
+			thread.join();
+
+		LA_CHECK(valid);
+	}
+
+	//an exception in any call, on the calling thread (the first index) or on a worker
+	for (size_t round = 0; round < NumRounds; round++)
+		LA_CHECK(rethrowsAfterAllCalls(64, (round * 13) % 64));
+
+	//and the workers are still there after the exceptions
+	LA_CHECK(runsEachIndexOnce(10000));
+
+	std::printf("%zu rounds checked\n", NumRounds);
+	return la::tests::result();
+}
@@ -0,0 +1,113 @@
+#include "checks.hpp"
+
+#include <lines_tools.hpp>
+#include <flavors_repo.hpp>
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace
+{
+	//COMLib lines with the usual params: short ids and counters (in the signatures) and longer names
+	std::string syntheticLog(size_t numLines)
+	{
+		constexpr std::array<const char*, 6> Names{ "SyncTask", "SendMsg", "Fetch", "Refresh", "net42", "0123456789abcdef" };
+
+		std::mt19937 random{ 7 };
+		std::uniform_int_distribution<int> pick{ 0, 5 };
+		std::uniform_int_distribution<int> id{ 1, 2000 };
+
+		std::string data;
+		for (size_t i = 0; i < numLines; i++)
+		{
+			char line[256];
+			switch (pick(random))
+			{
+			case 0:
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 1 |DEBUG|00|COMLib.Scheduler: schedule | task scheduled | id=%d; name=%s; \n", id(random), Names[static_cast<size_t>(pick(random))]);
+				break;
+			case 1:
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 2 |DEBUG|00|COMLib.HTTP: curlDebugCallback | data | request=%d; size=%d; \n", id(random), id(random));
+				break;
+			case 2:
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 3 |INFO |00|COMLib.ChatController: store | message stored | id=%d; networkId=%s; \n", id(random), Names[static_cast<size_t>(pick(random))]);
+				break;
+			case 3:
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 4 |INFO |00|COMLib.ChatController: store | message stored | MessageNetworkId=net%d; \n", id(random));
+				break;
+			case 4:
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 5 |DEBUG|00|COMLib.Debug: get | message %d with some text | a=%d; b=foo%d; \n", id(random), id(random), id(random));
+				break;
+			default:
+				std::snprintf(line, sizeof(line), "2023-03-26 00:53:43.420 6 |WARN |00|COMLib.Database: query | no params\n");
+				break;
+			}
+
+			data += line;
+		}
+
+		return data;
+	}
+}
+
+int main()
+{
+	constexpr size_t NumLines{ 50000 };
+	constexpr double MaxFalsePositiveRate{ 0.05 };
+
+	auto data = syntheticLog(NumLines);
+
+	std::vector<la::LogLine> lines;
+	std::vector<la::LogLineHeader> headers;
+	la::FlavorsRepo::processFileData(la::FlavorsRepo::Type::WCSCOMLib, data.data(), data.size(), lines, headers);
+	LA_CHECK(lines.size() == NumLines);
+	LA_CHECK(headers.size() == NumLines);
+
+	la::LinesTools linesTools{ lines };
+	linesTools.resizeHeaders(headers.size());
+	for (size_t i = 0; i < headers.size(); i++)
+		linesTools.setHeader(i, headers[i]);
+	linesTools.updateColumns(0);
+
+	constexpr std::array<std::string_view, 10> Filters{ "id=77", "id=1999", "request=5", "size=1000", "networkId=net42", "networkId=0123456789abcdef", "MessageNetworkId=net7", "a", "name", "unknown=1" };
+
+	for (auto filterStr : Filters)
+	{
+		la::LinesTools::FilterParam<la::LinesTools::FilterType::HasParam, std::string_view> filter{ filterStr };
+		filter.resolve(linesTools);
+
+		auto name = filterStr.substr(0, filterStr.find('='));
+		auto value = (name.size() < filterStr.size()) ? std::optional<std::string_view>{ filterStr.substr(name.size() + 1) } : std::nullopt;
+
+		size_t numMatches{ 0 }, numFalsePositives{ 0 };
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			std::string_view lineValue;
+			auto expected = (lines[i].paramExtract(name, lineValue) && (!value.has_value() || (lineValue == *value)));
+
+			//the signature never rejects a line with the param, and the filter matches exactly the lines with it
+			auto mayMatch = filter.mayMatch(linesTools, i);
+			if (!LA_CHECK(!expected || mayMatch) || !LA_CHECK(filter(linesTools, i) == expected) || !LA_CHECK(filter(lines[i]) == expected))
+				std::printf("  %.*s: line %zu\n", static_cast<int>(filterStr.size()), filterStr.data(), i);
+
+			numMatches += expected ? 1 : 0;
+			numFalsePositives += (mayMatch && !expected) ? 1 : 0;
+		}
+
+		//the rate is over the lines without the param (the ones the signature should reject)
+		auto numNonMatches = lines.size() - numMatches;
+		auto falsePositiveRate = (numNonMatches > 0) ? (static_cast<double>(numFalsePositives) / static_cast<double>(numNonMatches)) : 0.0;
+
+		std::printf("%-28.*s %6zu matches, false positive rate %.4f\n", static_cast<int>(filterStr.size()), filterStr.data(), numMatches, falsePositiveRate);
+
+		//only values up to 8 bytes are in the signatures, longer ones are only filtered by the name
+		if (value.has_value() && (value->size() <= sizeof(uint64_t)))
+			LA_CHECK(falsePositiveRate <= MaxFalsePositiveRate);
+	}
+
+	return la::tests::result();
+}
@@ -0,0 +1,154 @@
+#include "checks.hpp"
+
+#include <regex_searcher.hpp>
+
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <algorithm>
+
+namespace
+{
+	//a small alphabet, so the patterns are found often, with text the literal of the patterns is looked for
+	std::string randomText(std::mt19937& random, size_t size)
+	{
+		constexpr std::array<std::string_view, 10> Pieces{ "a", "A", "b", "B", "=", ";", " ", "1", "id=1;", "Ab " };
+		std::uniform_int_distribution<size_t> pick{ 0, Pieces.size() - 1 };
+
+		std::string text;
+		while (text.size() < size)
+			text += Pieces[pick(random)];
+
+		text.resize(size);
+		return text;
+	}
+
+	std::string randomAtom(std::mt19937& random, int depth);
+
+	//a few atoms with their quantifiers, alternated (the groups only get '?', so the regex doesn't backtrack for too long)
+	std::string randomPattern(std::mt19937& random, int depth)
+	{
+		std::string pattern;
+
+		auto numAlternatives = std::uniform_int_distribution<int>{ 0, 4 }(random) == 0 ? 2 : 1;
+		for (int alternative = 0; alternative < numAlternatives; alternative++)
+		{
+			if (alternative > 0)
+				pattern += '|';
+
+			auto numAtoms = std::uniform_int_distribution<int>{ 1, 4 }(random);
+			for (int i = 0; i < numAtoms; i++)
+			{
+				if (std::uniform_int_distribution<int>{ 0, 9 }(random) == 0)
+					pattern += "\\b";
+
+				auto atom = randomAtom(random, depth);
+				pattern += atom;
+
+				constexpr std::array<std::string_view, 8> Quantifiers{ "", "", "", "", "?", "*", "+", "{1,2}" };
+				auto quantifier = Quantifiers[std::uniform_int_distribution<size_t>{ 0, Quantifiers.size() - 1 }(random)];
+				if ((atom[0] == '(') && !quantifier.empty())
+					quantifier = "?";
+
+				pattern += quantifier;
+			}
+		}
+
+		return pattern;
+	}
+
+	std::string randomAtom(std::mt19937& random, int depth)
+	{
+		constexpr std::array<std::string_view, 14> Atoms{ "a", "b", "A", "=", ";", " ", "1", ".", "[ab]", "[^a]", "\\d", "\\w", "id=", "ab" };
+
+		auto pick = std::uniform_int_distribution<size_t>{ 0, Atoms.size() + 1 }(random);
+		if (pick < Atoms.size() || (depth >= 2))
+			return std::string{ Atoms[pick % Atoms.size()] };
+
+		if (pick == Atoms.size())
+			return "(" + randomPattern(random, depth + 1) + ")";
+
+		return "(?:" + randomPattern(random, depth + 1) + ")";
+	}
+
+	bool containsLiteral(std::string_view match, std::string_view literal, bool ignoreCase)
+	{
+		if (literal.empty())
+			return true;
+
+		return std::search(match.begin(), match.end(), literal.begin(), literal.end(), [ignoreCase](char lhs, char rhs)
+		{
+			return ignoreCase ? (std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs))) : (lhs == rhs);
+		}) != match.end();
+	}
+}
+
+int main()
+{
+	constexpr size_t NumRounds{ 20000 };
+
+	std::mt19937 random{ 5678 };
+
+	size_t numMatches{ 0 };
+	for (size_t round = 0; round < NumRounds; round++)
+	{
+		auto pattern = randomPattern(random, 0);
+		if (std::uniform_int_distribution<int>{ 0, 7 }(random) == 0)
+			pattern = "^" + pattern;
+		if (std::uniform_int_distribution<int>{ 0, 7 }(random) == 0)
+			pattern = "(?:" + pattern + ")$";
+
+		auto data = randomText(random, std::uniform_int_distribution<size_t>{ 0, 80 }(random));
+
+		for (auto ignoreCase : { false, true })
+		{
+			auto flags = ignoreCase ? (std::regex::ECMAScript | std::regex::icase) : std::regex::ECMAScript;
+
+			std::regex regex{ pattern, flags };
+			la::RegexSearcher searcher{ pattern, flags };
+
+			//every match is found in order, as when the searches continue after the previous match (so "^" and "\b" see a new start)
+			const char* dataEnd = data.data() + data.size();
+			for (const char* walker = data.data(); walker <= dataEnd; walker++)
+			{
+				std::cmatch expectedMatches;
+				auto found = std::regex_search(walker, dataEnd, expectedMatches, regex);
+				auto expected = found ? expectedMatches[0].first : dataEnd;
+
+				std::cmatch resultMatches;
+				auto result = searcher(walker, dataEnd);
+				auto resultFound = searcher.search(walker, dataEnd, resultMatches);
+
+				auto same = (result == expected) && (searcher.search(walker, dataEnd) == found) && (resultFound == found);
+				if (same && found)
+				{
+					same = (resultMatches[0].first == expectedMatches[0].first) && (resultMatches[0].second == expectedMatches[0].second);
+
+					//all the matches have the literal, and the size of a fixed size pattern
+					std::string_view match{ expectedMatches[0].first, static_cast<size_t>(expectedMatches[0].length()) };
+					same &= containsLiteral(match, searcher.literal(), ignoreCase);
+					same &= ((searcher.fixedSize() == 0) || (searcher.fixedSize() == match.size()));
+					numMatches++;
+				}
+
+				same &= (searcher.match(walker, dataEnd) == std::regex_match(walker, dataEnd, regex));
+
+				if (!LA_CHECK(same))
+				{
+					std::printf("  /%s/ in \"%s\" from %zu (ignore case %d)\n", pattern.c_str(), data.c_str(), static_cast<size_t>(walker - data.data()), ignoreCase ? 1 : 0);
+					break;
+				}
+
+				if (!found)
+					break;
+
+				walker = expected;
+			}
+		}
+	}
+
+	std::printf("%zu rounds checked (%zu matches)\n", NumRounds, numMatches);
+	return la::tests::result();
+}
@@ -0,0 +1,83 @@
+#include "checks.hpp"
+
+#include <text_searcher.hpp>
+
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <algorithm>
+
+namespace
+{
+	//a small alphabet, so the queries are found often (and nearly found even more), with rare and frequent first bytes
+	std::string randomText(std::mt19937& random, size_t size)
+	{
+		constexpr std::string_view Chars{ "aAbBzZ=; \n@{" };
+		std::uniform_int_distribution<size_t> pick{ 0, Chars.size() - 1 };
+
+		std::string text(size, ' ');
+		for (auto& c : text)
+			c = Chars[pick(random)];
+
+		return text;
+	}
+
+	const char* expectedFind(const char* dataStart, const char* dataEnd, const std::string& query, bool ignoreCase)
+	{
+		if (!ignoreCase)
+			return std::search(dataStart, dataEnd, query.begin(), query.end());
+
+		return std::search(dataStart, dataEnd, query.begin(), query.end(), [](char lhs, char rhs)
+		{
+			return (std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs)));
+		});
+	}
+}
+
+int main()
+{
+	constexpr size_t NumRounds{ 100000 };
+
+	std::mt19937 random{ 1234 };
+
+	for (size_t round = 0; round < NumRounds; round++)
+	{
+		auto query = randomText(random, std::uniform_int_distribution<size_t>{ 1, 6 }(random));
+		auto data = randomText(random, std::uniform_int_distribution<size_t>{ 0, 200 }(random));
+
+		//sometimes the query is in the data (possibly with another case)
+		if (!data.empty() && ((round % 3) == 0))
+		{
+			auto pos = std::uniform_int_distribution<size_t>{ 0, data.size() - 1 }(random);
+			data.replace(pos, std::min(query.size(), data.size() - pos), query.substr(0, data.size() - pos));
+		}
+
+		for (auto ignoreCase : { false, true })
+		{
+			la::TextSearcher searcher{ query, ignoreCase };
+
+			//every match is found in order, as when the searches continue after the previous match
+			const char* dataEnd = data.data() + data.size();
+			for (const char* walker = data.data(); walker <= dataEnd; walker++)
+			{
+				auto expected = expectedFind(walker, dataEnd, query, ignoreCase);
+				auto result = searcher(walker, dataEnd);
+				if (!LA_CHECK(result == expected))
+				{
+					std::printf("  \"%s\" in \"%s\" from %zu (ignore case %d)\n", query.c_str(), data.c_str(), static_cast<size_t>(walker - data.data()), ignoreCase ? 1 : 0);
+					break;
+				}
+
+				if (result == dataEnd)
+					break;
+
+				walker = result;
+			}
+		}
+	}
+
+	std::printf("%zu rounds checked\n", NumRounds);
+	return la::tests::result();
+}
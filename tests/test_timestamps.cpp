@@ -0,0 +1,109 @@
+#include "checks.hpp"
+
+#include <flavors_repo.hpp>
+
+#include <array>
+#include <ctime>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+
+namespace
+{
+	//the translation of a timestamp with mktime, as it was done for every line before the hour cache
+	int64_t mktimeTimestamp(const char* str)
+	{
+		std::tm timeData;
+		std::memset(&timeData, 0, sizeof(std::tm));
+
+		int timeMilliseconds{ 0 };
+		std::from_chars(str + 0, str + 4, timeData.tm_year);
+		std::from_chars(str + 5, str + 7, timeData.tm_mon);
+		std::from_chars(str + 8, str + 10, timeData.tm_mday);
+		std::from_chars(str + 11, str + 13, timeData.tm_hour);
+		std::from_chars(str + 14, str + 16, timeData.tm_min);
+		std::from_chars(str + 17, str + 19, timeData.tm_sec);
+		std::from_chars(str + 20, str + 23, timeMilliseconds);
+
+		timeData.tm_year = timeData.tm_year - 1900;
+		timeData.tm_mon--;
+		timeData.tm_isdst = -1;
+
+		auto timePoint = std::chrono::system_clock::from_time_t(std::mktime(&timeData));
+		return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch()).count()) + timeMilliseconds;
+	}
+
+	void setTimezone(const char* timezone)
+	{
+#if defined(_WIN32)
+		_putenv_s("TZ", timezone);
+		_tzset();
+#else
+		setenv("TZ", timezone, 1);
+		tzset();
+#endif
+	}
+
+	int daysInMonth(int year, int month)
+	{
+		constexpr std::array<int, 12> Days{ 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		auto isLeap = ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+		return Days[month - 1] + (((month == 2) && isLeap) ? 1 : 0);
+	}
+}
+
+int main()
+{
+	//the rules are given in the POSIX format, so the test doesn't depend on the timezone database of the machine
+	constexpr std::array<const char*, 5> Timezones{
+		"UTC0",
+		"WET0WEST,M3.5.0/1,M10.5.0", //Europe/Lisbon
+		"EST5EDT,M3.2.0,M11.1.0", //America/New_York
+		"NST3:30NDT,M3.2.0,M11.1.0", //America/St_Johns (half hour offset)
+		"<+1030>-10:30<+11>-11,M10.1.0,M4.1.0" //Australia/Lord_Howe (half hour DST)
+	};
+
+	for (auto timezone : Timezones)
+	{
+		setTimezone(timezone);
+
+		//the hour cached by the previous timezone is replaced (its offset would be wrong in this one)
+		la::FlavorsRepo::translateTimestamp("1999-12-31 23:59:59.999");
+
+		size_t numChecked{ 0 };
+		for (int year = 2023; year <= 2024; year++)
+		{
+			for (int month = 1; month <= 12; month++)
+			{
+				for (int day = 1; day <= daysInMonth(year, month); day++)
+				{
+					//every hour, including the ones skipped or repeated by DST changes, with a few minutes each
+					for (int hour = 0; hour < 24; hour++)
+					{
+						for (int minute = 0; minute < 60; minute += 3)
+						{
+							auto second = ((minute * 7) + hour) % 60;
+							auto milliseconds = (minute * 37) % 1000;
+
+							std::array<char, 32> timestamp;
+							std::snprintf(timestamp.data(), timestamp.size(), "%04d-%02d-%02d %02d:%02d:%02d.%03d", year, month, day, hour, minute, second, milliseconds);
+
+							auto expected = mktimeTimestamp(timestamp.data());
+							auto result = la::FlavorsRepo::translateTimestamp(timestamp.data());
+							if (!LA_CHECK(result == expected))
+								std::printf("  TZ=%s %s: %lld (mktime %lld)\n", timezone, timestamp.data(), static_cast<long long>(result), static_cast<long long>(expected));
+
+							numChecked++;
+						}
+					}
+				}
+			}
+		}
+
+		std::printf("TZ=%s: %zu timestamps checked\n", timezone, numChecked);
+	}
+
+	return la::tests::result();
+}
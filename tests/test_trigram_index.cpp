@@ -0,0 +1,192 @@
+#include "checks.hpp"
+
+#include <log_line.hpp>
+#include <trigram_index.hpp>
+#include <regex_searcher.hpp>
+
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+	constexpr std::string_view Chars{ "abcdeABCDE=; 1" };
+
+	//runs of lines made of a few of the chars, so most trigrams are only in some of the blocks
+	std::string randomLog(std::mt19937& random, size_t numLines)
+	{
+		std::string data;
+		for (size_t line = 0; line < numLines; )
+		{
+			std::string runChars;
+			for (size_t i = 0; i < 4; i++)
+				runChars += Chars[std::uniform_int_distribution<size_t>{ 0, Chars.size() - 1 }(random)];
+
+			std::uniform_int_distribution<size_t> pick{ 0, runChars.size() - 1 };
+			auto runEnd = std::min(numLines, line + std::uniform_int_distribution<size_t>{ 1, 600 }(random));
+			for (; line < runEnd; line++)
+			{
+				auto size = std::uniform_int_distribution<size_t>{ 0, 40 }(random);
+				for (size_t i = 0; i < size; i++)
+					data += runChars[pick(random)];
+
+				data += '\n';
+			}
+		}
+
+		return data;
+	}
+
+	std::vector<la::LogLine> splitLines(const std::string& data)
+	{
+		std::vector<la::LogLine> lines;
+		for (size_t start = 0; start < data.size(); )
+		{
+			auto end = data.find('\n', start);
+
+			la::LogLine line{};
+			line.dataStart = data.data() + start;
+			line.setDataEnd(data.data() + end);
+			lines.push_back(line);
+
+			start = end + 1;
+		}
+
+		return lines;
+	}
+
+	std::string randomQuery(std::mt19937& random)
+	{
+		std::string query(std::uniform_int_distribution<size_t>{ 0, 6 }(random), ' ');
+		for (auto& c : query)
+			c = Chars[std::uniform_int_distribution<size_t>{ 0, Chars.size() - 1 }(random)];
+
+		return query;
+	}
+
+	//a regex around a text, so its literal is used with the index
+	std::string randomPattern(std::mt19937& random)
+	{
+		constexpr std::array<std::string_view, 8> Atoms{ "", "", "a?", "[bc]", "\\d*", ".", "(?:D|;)", "\\b" };
+		std::uniform_int_distribution<size_t> pick{ 0, Atoms.size() - 1 };
+
+		std::string pattern{ Atoms[pick(random)] };
+		pattern += randomQuery(random);
+		pattern += Atoms[pick(random)];
+		if (std::uniform_int_distribution<int>{ 0, 3 }(random) == 0)
+			pattern += "|" + randomQuery(random) + std::string{ Atoms[pick(random)] };
+
+		return pattern;
+	}
+
+	//the candidates are in order and in the window, and include every block of the window with a line found by "cbFound"
+	bool checkCandidates(const la::TrigramIndex& index, const std::vector<la::LogLine>& lines, std::string_view text, std::mt19937& random, const std::function<bool(const la::LogLine&)>& cbFound)
+	{
+		auto numBlocks = static_cast<uint32_t>(index.numBlocks());
+		auto blockStart = std::uniform_int_distribution<uint32_t>{ 0, numBlocks }(random);
+		auto blockEnd = std::uniform_int_distribution<uint32_t>{ blockStart, numBlocks }(random);
+
+		auto candidates = index.candidateBlocks(text, blockStart, blockEnd);
+		if (text.size() < 3)
+			return !candidates.has_value();
+		if (!candidates.has_value())
+			return false;
+
+		const auto& blocks = candidates.value();
+		if (!std::is_sorted(blocks.begin(), blocks.end()) || (std::adjacent_find(blocks.begin(), blocks.end()) != blocks.end()))
+			return false;
+		if (!blocks.empty() && ((blocks.front() < blockStart) || (blocks.back() >= blockEnd)))
+			return false;
+
+		for (auto block = blockStart; block < blockEnd; block++)
+		{
+			auto lineIndex = static_cast<size_t>(block) * la::TrigramIndex::BlockSize;
+			auto lineIndexEnd = std::min(lineIndex + la::TrigramIndex::BlockSize, index.numLines());
+
+			auto found = std::any_of(lines.begin() + lineIndex, lines.begin() + lineIndexEnd, cbFound);
+			if (found && !std::binary_search(blocks.begin(), blocks.end(), block))
+			{
+				std::printf("  block %u skipped for \"%.*s\" in [%u, %u)\n", block, static_cast<int>(text.size()), text.data(), blockStart, blockEnd);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool containsIgnoreCase(const la::LogLine& line, std::string_view text)
+	{
+		auto data = line.toStr();
+		return std::search(data.begin(), data.end(), text.begin(), text.end(), [](char lhs, char rhs)
+		{
+			return (std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs)));
+		}) != data.end();
+	}
+
+	void checkIndex(const la::TrigramIndex& index, const std::vector<la::LogLine>& lines, std::mt19937& random, size_t numRounds)
+	{
+		for (size_t round = 0; round < numRounds; round++)
+		{
+			//a text is searched with the case ignored or not, the index folds it in both cases
+			auto query = randomQuery(random);
+			LA_CHECK(checkCandidates(index, lines, query, random, [&query](const la::LogLine& line) { return containsIgnoreCase(line, query); }));
+
+			auto pattern = randomPattern(random);
+			auto ignoreCase = (std::uniform_int_distribution<int>{ 0, 1 }(random) == 0);
+			auto flags = ignoreCase ? (std::regex::ECMAScript | std::regex::icase) : std::regex::ECMAScript;
+
+			la::RegexSearcher searcher{ pattern, flags };
+			if (!LA_CHECK(checkCandidates(index, lines, searcher.literal(), random, [&searcher](const la::LogLine& line) { return searcher.search(line.dataStart, line.dataEnd()); })))
+				std::printf("  /%s/ (ignore case %d)\n", pattern.c_str(), ignoreCase ? 1 : 0);
+		}
+	}
+}
+
+int main()
+{
+	constexpr size_t NumLines{ 20000 };
+	constexpr size_t NumRounds{ 2000 };
+	constexpr size_t NumResizes{ 20 };
+
+	std::mt19937 random{ 8765 };
+
+	auto data = randomLog(random, NumLines);
+	auto allLines = splitLines(data);
+	LA_CHECK(allLines.size() == NumLines);
+
+	std::atomic<bool> cancel{ false };
+
+	la::TrigramIndex index;
+	LA_CHECK(index.extend(allLines, cancel));
+	LA_CHECK(index.numLines() == allLines.size());
+	checkIndex(index, allLines, random, NumRounds);
+
+	//the lines removed and added again, as when a file is refreshed (through partial blocks, which are indexed again)
+	std::vector<la::LogLine> lines{ allLines };
+	for (size_t resize = 0; resize < NumResizes; resize++)
+	{
+		auto truncatedLines = std::uniform_int_distribution<size_t>{ 0, lines.size() }(random);
+		index.truncate(truncatedLines);
+		LA_CHECK(index.numLines() <= truncatedLines);
+		LA_CHECK((truncatedLines - index.numLines()) < la::TrigramIndex::BlockSize);
+		checkIndex(index, lines, random, NumRounds / NumResizes);
+
+		//in two steps, so the second one starts in the last block of the first one
+		for (size_t step = 0; step < 2; step++)
+		{
+			lines.assign(allLines.begin(), allLines.begin() + std::uniform_int_distribution<size_t>{ std::max(truncatedLines, index.numLines()), allLines.size() }(random));
+			LA_CHECK(index.extend(lines, cancel));
+			LA_CHECK(index.numLines() == lines.size());
+			checkIndex(index, lines, random, NumRounds / NumResizes);
+		}
+	}
+
+	std::printf("%zu rounds and %zu resizes checked\n", NumRounds, NumResizes);
+	return la::tests::result();
+}